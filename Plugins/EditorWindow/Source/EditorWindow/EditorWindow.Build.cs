@@ -25,7 +25,8 @@ public class EditorWindow : ModuleRules
 		PublicDependencyModuleNames.AddRange(
 			new string[]
 			{
-				"Core"
+				"Core",
+				"EditorWindowRuntime"
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -46,7 +47,9 @@ public class EditorWindow : ModuleRules
                 "DesktopWidgets",
 				"DesktopPlatform",
                 "PropertyEditor",
-                "EditorScriptingUtilities"
+                "EditorScriptingUtilities",
+				"WorldBrowser",
+				"PythonScriptPlugin"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ActorTagIndex.h"
+#include "EditorWindow.h"
+#include "EngineUtils.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "UObject/UObjectGlobals.h"
+
+FActorTagIndex::~FActorTagIndex()
+{
+	Shutdown();
+}
+
+void FActorTagIndex::Bind()
+{
+	if (bBound || GEngine == nullptr) return;
+
+	ActorAddedHandle = GEngine->OnLevelActorAdded().AddRaw(this, &FActorTagIndex::OnActorAdded);
+	ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this, &FActorTagIndex::OnActorDeleted);
+	PropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FActorTagIndex::OnObjectPropertyChanged);
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FActorTagIndex::OnLevelChanged);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FActorTagIndex::OnLevelChanged);
+	bBound = true;
+}
+
+void FActorTagIndex::Shutdown()
+{
+	if (!bBound) return;
+
+	if (GEngine)
+	{
+		GEngine->OnLevelActorAdded().Remove(ActorAddedHandle);
+		GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+	}
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(PropertyChangedHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	ActorsByTag.Empty();
+	bBound = false;
+	bDirty = true;
+}
+
+void FActorTagIndex::MarkDirty()
+{
+	bDirty = true;
+}
+
+void FActorTagIndex::SuspendUpdates()
+{
+	SuspendCount++;
+}
+
+void FActorTagIndex::ResumeUpdates(TConstArrayView<AActor*> SpawnedActors)
+{
+	SuspendCount--;
+	check(SuspendCount >= 0);
+
+	if (bDirty) return;
+
+	for (AActor* SpawnedActor : SpawnedActors)
+	{
+		if (SpawnedActor && SpawnedActor->GetWorld() == IndexedWorld.Get()) AddActor(SpawnedActor);
+	}
+}
+
+const TMap<ULevel*, TArray<AActor*>>* FActorTagIndex::FindActorsByLevel(UWorld* World, FName Tag)
+{
+	if (bDirty || IndexedWorld.Get() != World) Rebuild(World);
+
+	return ActorsByTag.Find(Tag);
+}
+
+TArray<AActor*> FActorTagIndex::GetActors(UWorld* World, FName Tag)
+{
+	TArray<AActor*> Actors;
+	if (const TMap<ULevel*, TArray<AActor*>>* ActorsInLevels = FindActorsByLevel(World, Tag))
+	{
+		for (const TPair<ULevel*, TArray<AActor*>>& ActorsInLevel : *ActorsInLevels)
+		{
+			Actors.Append(ActorsInLevel.Value);
+		}
+	}
+	return Actors;
+}
+
+void FActorTagIndex::Rebuild(UWorld* World)
+{
+	Bind();
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	ActorsByTag.Reset();
+	IndexedWorld = World;
+	bDirty = false;
+	if (World == nullptr) return;
+
+	// single pass over all actors, same iteration order as GetAllActorsWithTag
+	int32 NumActors = 0;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		AddActor(*It);
+		NumActors++;
+	}
+
+	UE_LOG(LogEditorWindow, Log, TEXT("Tag index rebuilt: %d actors, %d tags in %.2f ms"),
+		NumActors, ActorsByTag.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FActorTagIndex::AddActor(AActor* Actor)
+{
+	// an actor is only added once per tag, so skip repeated tags instead of searching the (possibly huge) list
+	const TArray<FName>& Tags = Actor->Tags;
+	for (int32 TagIndex = 0; TagIndex < Tags.Num(); TagIndex++)
+	{
+		if (Tags.Find(Tags[TagIndex]) != TagIndex) continue;
+
+		ActorsByTag.FindOrAdd(Tags[TagIndex]).FindOrAdd(Actor->GetLevel()).Add(Actor);
+	}
+}
+
+void FActorTagIndex::OnActorAdded(AActor* Actor)
+{
+	if (bDirty || SuspendCount > 0 || Actor == nullptr || Actor->GetWorld() != IndexedWorld.Get()) return;
+
+	AddActor(Actor);
+}
+
+void FActorTagIndex::OnActorDeleted(AActor* Actor)
+{
+	if (bDirty || SuspendCount > 0 || Actor == nullptr || Actor->GetWorld() != IndexedWorld.Get()) return;
+
+	for (const FName& Tag : Actor->Tags)
+	{
+		TMap<ULevel*, TArray<AActor*>>* ActorsInLevels = ActorsByTag.Find(Tag);
+		if (ActorsInLevels == nullptr) continue;
+
+		if (TArray<AActor*>* ActorsInLevel = ActorsInLevels->Find(Actor->GetLevel()))
+		{
+			ActorsInLevel->Remove(Actor);
+			if (ActorsInLevel->Num() == 0) ActorsInLevels->Remove(Actor->GetLevel());
+		}
+		if (ActorsInLevels->Num() == 0) ActorsByTag.Remove(Tag);
+	}
+}
+
+void FActorTagIndex::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// the old tags aren't known anymore, so a tag edit rebuilds on the next query
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(AActor, Tags) && Object && Object->IsA<AActor>())
+	{
+		MarkDirty();
+	}
+}
+
+void FActorTagIndex::OnLevelChanged(ULevel* Level, UWorld* World)
+{
+	if (World == IndexedWorld.Get()) MarkDirty();
+}
@@ -0,0 +1,309 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DungeonGenBenchmark.h"
+#include "EditorWindow.h"
+#include "ActorTagIndex.h"
+#include "BulkActorSpawner.h"
+#include "DungeonGenerator.h"
+#include "GeneratorTypes.h"
+#include "Editor.h"
+#include "Engine/DataTable.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "Engine/StaticMeshActor.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+namespace
+{
+	const TCHAR* CsvHeader = TEXT("Pass,Rows,Actors,Milliseconds,UsedMB,PeakMB");
+	const TCHAR* RoomMountPoint = TEXT("/DungeonGenBenchmark/");
+
+	FString GetRoomPackageName(int32 Index)
+	{
+		return FString::Printf(TEXT("/DungeonGenBenchmark/Room_%d"), Index);
+	}
+
+	FString GetRoomPath(int32 Index)
+	{
+		return FString::Printf(TEXT("/DungeonGenBenchmark/Room_%d.Room_%d"), Index, Index);
+	}
+
+	FName GetBenchmarkTag(int32 Index)
+	{
+		return FName(*FString::Printf(TEXT("BenchmarkTag_%d"), Index));
+	}
+}
+
+void FDungeonGenBenchmark::RunScale(int32 NumRows, int32 NumActors)
+{
+	UE_LOG(LogEditorWindow, Display, TEXT("Benchmark: %d rows, %d actors"), NumRows, NumActors);
+
+	FEditorWindowModule& EditorWindowModule = FModuleManager::LoadModuleChecked<FEditorWindowModule>("EditorWindow");
+
+	MakeRoomWorlds(NumRows);
+
+	// an empty map, the passes run on the editor world and the scale removes everything it made by leaving it
+	UWorld* World = GEditor->NewMap();
+	if (World == nullptr)
+	{
+		bFailed = true;
+		return;
+	}
+
+	UDataTable* LevelsTable = MakeLevelsTable(NumRows);
+	UDataTable* TagsTable = MakeTagsTable(NumRows, NumActors);
+	UDataTable* ActorsTable = MakeActorsTable();
+
+	// one layout level per row, on a grid
+	Measure(TEXT("LayoutLoad"), NumRows, NumActors, [&]()
+	{
+		const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(float(NumRows)));
+		for (int32 Index = 0; Index < NumRows; Index++)
+		{
+			bool bSuccess = false;
+			const FVector Location = FVector(Index % GridSize, Index / GridSize, 0) * 2000.0;
+			ULevelStreamingDynamic::LoadLevelInstance(World, GetRoomPackageName(Index), Location, FRotator::ZeroRotator, bSuccess);
+			if (!bSuccess) bFailed = true;
+		}
+		World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+	});
+
+	// half tagged actors for the tags pass, half static mesh actors for the actors pass
+	Measure(TEXT("Populate"), NumRows, NumActors, [&]()
+	{
+		TArray<FActorSpawnRequest> Requests;
+		Requests.Reserve(NumActors);
+		for (int32 Index = 0; Index < NumActors; Index++)
+		{
+			FActorSpawnRequest& Request = Requests.AddDefaulted_GetRef();
+			Request.Class = Index % 2 == 0 ? AActor::StaticClass() : AStaticMeshActor::StaticClass();
+			Request.Transform.SetLocation(FVector(Index % 1000, Index / 1000, 0) * 100.0);
+		}
+
+		TArray<AActor*> Actors = FBulkActorSpawner::SpawnActors(World, Requests);
+		for (int32 Index = 0; Index < Actors.Num(); Index += 2)
+		{
+			if (Actors[Index]) Actors[Index]->Tags.Add(GetBenchmarkTag((Index / 2) % NumRows));
+		}
+	});
+
+	for (FName GeneratorName : FDungeonGeneratorRegistry::Get().GetNames())
+	{
+		const IDungeonGenerator* Generator = FDungeonGeneratorRegistry::Get().Find(GeneratorName);
+
+		FDungeonGeneratorInput Input;
+		Input.LevelsDataTable = LevelsTable;
+		Input.TagsDataTable = TagsTable;
+		Input.ActorsDataTable = ActorsTable;
+		Input.Seed = 1;
+		Input.NumRooms = NumRows;
+
+		// twice as many cells as rooms
+		const float HalfSize = FMath::CeilToFloat(FMath::Sqrt(2.f * NumRows)) * Input.CellSize * 0.5f;
+		Input.Bounds = FBox(FVector(-HalfSize, -HalfSize, 0.f), FVector(HalfSize, HalfSize, 0.f));
+
+		Measure(TEXT("Layout.") + GeneratorName.ToString(), NumRows, NumActors, [&]()
+		{
+			FDungeonLayout Layout;
+			if (!Generator->Generate(Input, Layout)) bFailed = true;
+		});
+	}
+
+	// selection, world loading and instancing of the replacement levels, until they are streamed in
+	Measure(TEXT("Levels"), NumRows, NumActors, [&]()
+	{
+		EditorWindowModule.GenerateLevels(LevelsTable, 1);
+		World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+	});
+
+	if (PluginManager::GetGeneratedLevels().Num() < NumRows) bFailed = true;
+
+	Measure(TEXT("TagIndex"), NumRows, NumActors, [&]()
+	{
+		FActorTagIndex TagIndex;
+		TagIndex.GetActors(World, GetBenchmarkTag(0));
+		TagIndex.Shutdown();
+	});
+
+	Measure(TEXT("Tags"), NumRows, NumActors, [&]()
+	{
+		EditorWindowModule.GenerateTags(TagsTable, 1);
+	});
+
+	Measure(TEXT("Actors"), NumRows, NumActors, [&]()
+	{
+		EditorWindowModule.GenerateActors(ActorsTable, 1);
+	});
+
+	GEditor->NewMap();
+	LevelsTable->RemoveFromRoot();
+	TagsTable->RemoveFromRoot();
+	ActorsTable->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+FString FDungeonGenBenchmark::ToCsv() const
+{
+	FString Csv = FString(CsvHeader) + LINE_TERMINATOR;
+	for (const FDungeonGenBenchmarkResult& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("%s,%d,%d,%.3f,%.1f,%.1f") LINE_TERMINATOR,
+			*Result.Pass, Result.Rows, Result.Actors, Result.Milliseconds, Result.UsedMB, Result.PeakMB);
+	}
+	return Csv;
+}
+
+int32 FDungeonGenBenchmark::CompareWithBaseline(const FString& BaselinePath, double Tolerance) const
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *BaselinePath))
+	{
+		UE_LOG(LogEditorWindow, Error, TEXT("Baseline %s could not be read."), *BaselinePath);
+		return 1;
+	}
+
+	TMap<FString, double> BaselineTimes;
+	for (const FString& Line : Lines)
+	{
+		TArray<FString> Columns;
+		Line.ParseIntoArray(Columns, TEXT(","));
+		if (Columns.Num() < 4 || Columns[0] == TEXT("Pass")) continue;
+
+		BaselineTimes.Add(FString::Printf(TEXT("%s|%s|%s"), *Columns[0], *Columns[1], *Columns[2]), FCString::Atod(*Columns[3]));
+	}
+
+	int32 NumRegressions = 0;
+	for (const FDungeonGenBenchmarkResult& Result : Results)
+	{
+		const double* BaselineTime = BaselineTimes.Find(Result.GetKey());
+		if (BaselineTime == nullptr) continue;
+
+		// ignore sub-millisecond noise
+		if (Result.Milliseconds > *BaselineTime * Tolerance && Result.Milliseconds - *BaselineTime > 1.0)
+		{
+			UE_LOG(LogEditorWindow, Error, TEXT("Regression: %s (%d rows, %d actors) took %.2f ms, baseline %.2f ms"),
+				*Result.Pass, Result.Rows, Result.Actors, Result.Milliseconds, *BaselineTime);
+			NumRegressions++;
+		}
+	}
+	return NumRegressions;
+}
+
+FString FDungeonGenBenchmark::GetDefaultOutputPath()
+{
+	return FPaths::ProfilingDir() / TEXT("DungeonGen") / FString::Printf(TEXT("Benchmark-%s.csv"), *FDateTime::Now().ToString());
+}
+
+template<typename FunctionType>
+void FDungeonGenBenchmark::Measure(const FString& Pass, int32 NumRows, int32 NumActors, FunctionType&& Function)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	Function();
+
+	FDungeonGenBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+	Result.Pass = Pass;
+	Result.Rows = NumRows;
+	Result.Actors = NumActors;
+	Result.Milliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	Result.UsedMB = MemoryStats.UsedPhysical / (1024.0 * 1024.0);
+	Result.PeakMB = MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0);
+
+	UE_LOG(LogEditorWindow, Display, TEXT("  %-24s %10.2f ms %8.1f MB (peak %.1f MB)"), *Pass, Result.Milliseconds, Result.UsedMB, Result.PeakMB);
+}
+
+void FDungeonGenBenchmark::MakeRoomWorlds(int32 NumRooms)
+{
+	if (!FPackageName::MountPointExists(RoomMountPoint))
+	{
+		FPackageName::RegisterMountPoint(RoomMountPoint, FPaths::ProjectIntermediateDir() / TEXT("DungeonGenBenchmark/"));
+	}
+
+	// empty worlds, the cost measured is streaming and instancing them, not their content
+	bool bSavedRooms = false;
+	for (int32 Index = 0; Index < NumRooms; Index++)
+	{
+		const FString PackageName = GetRoomPackageName(Index);
+		if (FPackageName::DoesPackageExist(PackageName)) continue;
+
+		UPackage* Package = CreatePackage(*PackageName);
+		UWorld* RoomWorld = UWorld::CreateWorld(EWorldType::Inactive, false, FName(*FPackageName::GetShortName(PackageName)), Package);
+		RoomWorld->SetFlags(RF_Public | RF_Standalone);
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		const FString FileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetMapPackageExtension());
+		if (!UPackage::SavePackage(Package, RoomWorld, *FileName, SaveArgs)) bFailed = true;
+
+		RoomWorld->DestroyWorld(false);
+		RoomWorld->ClearFlags(RF_Public | RF_Standalone);
+		bSavedRooms = true;
+	}
+
+	// the passes load the rooms from disk like any other level
+	if (bSavedRooms) CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+// every row replaces its room with one of the next four rooms
+UDataTable* FDungeonGenBenchmark::MakeLevelsTable(int32 NumRows)
+{
+	UDataTable* DataTable = NewObject<UDataTable>(GetTransientPackage(), NAME_None, RF_Transient);
+	DataTable->AddToRoot();
+	DataTable->RowStruct = FLevelsStruct::StaticStruct();
+
+	for (int32 Index = 0; Index < NumRows; Index++)
+	{
+		FLevelsStruct Row;
+		Row.World = TSoftObjectPtr<UWorld>(FSoftObjectPath(GetRoomPath(Index)));
+		for (int32 Offset = 1; Offset <= 4; Offset++)
+		{
+			FWeightedWorld ReplaceWorld;
+			ReplaceWorld.World = TSoftObjectPtr<UWorld>(FSoftObjectPath(GetRoomPath((Index + Offset) % NumRows)));
+			ReplaceWorld.Weight = Offset;
+			Row.ReplaceWorlds.Add(ReplaceWorld);
+		}
+		DataTable->AddRow(FName(*FString::Printf(TEXT("Row_%d"), Index)), Row);
+	}
+	return DataTable;
+}
+
+// one row per tag, each replacing half of its actors
+UDataTable* FDungeonGenBenchmark::MakeTagsTable(int32 NumRows, int32 NumActors)
+{
+	UDataTable* DataTable = NewObject<UDataTable>(GetTransientPackage(), NAME_None, RF_Transient);
+	DataTable->AddToRoot();
+	DataTable->RowStruct = FTagsStruct::StaticStruct();
+
+	const int32 ActorsPerTag = NumActors / 2 / NumRows;
+	for (int32 Index = 0; Index < NumRows; Index++)
+	{
+		FTagsStruct Row;
+		Row.ActorTag = GetBenchmarkTag(Index);
+		Row.NumberOfElements = uint8(FMath::Clamp(ActorsPerTag / 2, 1, 255));
+		Row.ReplaceActor = AActor::StaticClass();
+		DataTable->AddRow(FName(*FString::Printf(TEXT("Row_%d"), Index)), Row);
+	}
+	return DataTable;
+}
+
+// replaces all static mesh actors
+UDataTable* FDungeonGenBenchmark::MakeActorsTable()
+{
+	UDataTable* DataTable = NewObject<UDataTable>(GetTransientPackage(), NAME_None, RF_Transient);
+	DataTable->AddToRoot();
+	DataTable->RowStruct = FActorsStruct::StaticStruct();
+
+	FActorsStruct Row;
+	Row.Actor = AStaticMeshActor::StaticClass();
+	FWeightedActor ReplaceActor;
+	ReplaceActor.Actor = AActor::StaticClass();
+	ReplaceActor.Weight = 1;
+	Row.ReplaceActors.Add(ReplaceActor);
+	DataTable->AddRow(TEXT("Row_0"), Row);
+	return DataTable;
+}
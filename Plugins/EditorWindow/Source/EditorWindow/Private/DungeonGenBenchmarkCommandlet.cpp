@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DungeonGenBenchmarkCommandlet.h"
+#include "DungeonGenBenchmark.h"
+#include "EditorWindow.h"
+#include "Misc/FileHelper.h"
+
+namespace
+{
+	// comma separated list of positive numbers
+	TArray<int32> ParseScales(const FString& Params, const TCHAR* Key, const TArray<int32>& Default)
+	{
+		FString Value;
+		if (!FParse::Value(*Params, Key, Value, false)) return Default;
+
+		TArray<FString> Parts;
+		Value.ParseIntoArray(Parts, TEXT(","));
+
+		TArray<int32> Scales;
+		for (const FString& Part : Parts)
+		{
+			const int32 Scale = FCString::Atoi(*Part);
+			if (Scale > 0) Scales.Add(Scale);
+		}
+		return Scales.Num() > 0 ? Scales : Default;
+	}
+}
+
+UDungeonGenBenchmarkCommandlet::UDungeonGenBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UDungeonGenBenchmarkCommandlet::Main(const FString& Params)
+{
+	const TArray<int32> Rows = ParseScales(Params, TEXT("Rows="), { 10, 100, 1000, 10000 });
+	const TArray<int32> Actors = ParseScales(Params, TEXT("Actors="), { 100, 1000, 10000, 100000 });
+
+	FDungeonGenBenchmark Benchmark;
+	const int32 NumScales = FMath::Max(Rows.Num(), Actors.Num());
+	for (int32 Index = 0; Index < NumScales; Index++)
+	{
+		Benchmark.RunScale(Rows[FMath::Min(Index, Rows.Num() - 1)], Actors[FMath::Min(Index, Actors.Num() - 1)]);
+	}
+
+	FString OutputPath;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputPath = FDungeonGenBenchmark::GetDefaultOutputPath();
+	}
+
+	if (!FFileHelper::SaveStringToFile(Benchmark.ToCsv(), *OutputPath))
+	{
+		UE_LOG(LogEditorWindow, Error, TEXT("Benchmark results could not be written to %s"), *OutputPath);
+		return 1;
+	}
+	UE_LOG(LogEditorWindow, Display, TEXT("Benchmark results written to %s"), *OutputPath);
+
+	int32 NumRegressions = 0;
+	FString BaselinePath;
+	if (FParse::Value(*Params, TEXT("Baseline="), BaselinePath))
+	{
+		float Tolerance = 1.5f;
+		FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+		NumRegressions = Benchmark.CompareWithBaseline(BaselinePath, Tolerance);
+	}
+
+	if (Benchmark.bFailed) UE_LOG(LogEditorWindow, Error, TEXT("A generator pass failed on the synthetic data."));
+
+	return (Benchmark.bFailed || NumRegressions > 0) ? 1 : 0;
+}
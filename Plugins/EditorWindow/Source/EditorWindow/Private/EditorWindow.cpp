@@ -14,7 +14,7 @@
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Input/SDirectoryPicker.h"
 #include "PropertyCustomizationHelpers.h"
-#include "WorldBrowser/Public/WorldBrowserModule.h"
+#include "LevelBrowserRefresh.h"
 #include "EditorLevelUtils.h"
 #include "Engine/LevelStreamingDynamic.h"
 #include "Engine/LevelStreamingAlwaysLoaded.h"
@@ -25,13 +25,72 @@
 #include "Framework/Application/SlateApplication.h"
 #include "GeneratorActor.h"
 #include "GeneratorScript.h"
+#include "PluginAPI.h"
+#include "GeneratorSelection.h"
 #include <Kismet/KismetMathLibrary.h>
 #include "Widgets/Layout/SBorder.h"
+#include "LevelUtils.h"
+#include "ScopedTransaction.h"
+#include "Editor/TransBuffer.h"
+#include "EditorWindowRuntime.h"
+#include "Async/ParallelFor.h"
 
 static const FName EditorWindowTabName("EditorWindow");
 
+DEFINE_LOG_CATEGORY(LogEditorWindow);
+
+DECLARE_CYCLE_STAT(TEXT("Generate Levels"), STAT_DungeonGen_GenerateLevels, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Generate Tags"), STAT_DungeonGen_GenerateTags, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Generate Actors"), STAT_DungeonGen_GenerateActors, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Merge"), STAT_DungeonGen_Merge, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Apply Manifest"), STAT_DungeonGen_ApplyManifest, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Native Generator"), STAT_DungeonGen_NativeGenerator, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Row Lookup"), STAT_DungeonGen_RowLookup, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("World Load"), STAT_DungeonGen_WorldLoad, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Level Selection"), STAT_DungeonGen_LevelSelection, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Replacement Spawning"), STAT_DungeonGen_ReplacementSpawning, STATGROUP_DungeonGen);
+
 #define LOCTEXT_NAMESPACE "FEditorWindowModule"
 
+// layout level of the levels pass and the replacement world chosen for it
+struct FLevelReplacementSlot
+{
+	ULevelStreaming* LayoutLevel = nullptr;
+	FManifestLevelRef LayoutRef;
+	const FLevelsStruct* RowData = nullptr;
+	int32 SumOfWeights = 0;
+
+	// filled by the parallel selection
+	TSoftObjectPtr<UWorld> ReplaceWorld;
+};
+
+// wraps a whole generator pass in a single undo step and reports the undo buffer size once the pass is done;
+// with undo recording disabled nothing gets recorded at all
+class FGeneratorTransaction
+{
+public:
+	FGeneratorTransaction(const FText& Description, bool bRecordUndo)
+		: Transaction(MakeUnique<FScopedTransaction>(Description, bRecordUndo))
+	{
+	}
+
+	~FGeneratorTransaction()
+	{
+		Transaction.Reset();
+
+		if (UTransBuffer* TransBuffer = Cast<UTransBuffer>(GEditor->Trans))
+		{
+			UE_LOG(LogEditorWindow, Log, TEXT("Undo buffer: %d transactions, %.2f MB used of %.2f MB"),
+				TransBuffer->GetQueueLength(),
+				TransBuffer->GetUndoSize() / (1024.0 * 1024.0),
+				TransBuffer->MaxMemory / (1024.0 * 1024.0));
+		}
+	}
+
+private:
+	TUniquePtr<FScopedTransaction> Transaction;
+};
+
 void FEditorWindowModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
@@ -69,6 +128,11 @@ void FEditorWindowModule::ShutdownModule()
 	FEditorWindowCommands::Unregister();
 
 	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(EditorWindowTabName);
+
+	TagIndex.Shutdown();
+
+	ReplacementLevels.Unbind();
+	GeneratedLevels.Unbind();
 }
 
 
@@ -84,6 +148,13 @@ TSharedRef<SDockTab> FEditorWindowModule::OnSpawnPluginTab(const FSpawnTabArgs&
 	ComboItems.Add(MakeShareable(new ExecutionMethod(Blueprint)));
 	ComboItems.Add(MakeShareable(new ExecutionMethod(CPP)));
 
+	NativeGeneratorItems.Empty();
+	NativeGeneratorItems.Add(MakeShareable(new FName(NAME_None)));
+	for (FName GeneratorName : FDungeonGeneratorRegistry::Get().GetNames())
+	{
+		NativeGeneratorItems.Add(MakeShareable(new FName(GeneratorName)));
+	}
+
 	return SNew(SDockTab)
 		.TabRole(ETabRole::NomadTab)
 		[
@@ -216,6 +287,7 @@ TSharedRef<SDockTab> FEditorWindowModule::OnSpawnPluginTab(const FSpawnTabArgs&
 								.HAlign(HAlign_Center)
 								.OnClicked_Lambda([this]() {
 									FilePath = "";
+									PythonContext.Reset();
 									return FReply::Handled();
 								})
 							]
@@ -275,8 +347,30 @@ TSharedRef<SDockTab> FEditorWindowModule::OnSpawnPluginTab(const FSpawnTabArgs&
 								return FSlateRenderTransform(FScale2D(0.0f), FVector2D(0.f, 0.f));
 						})
 						+ SHorizontalBox::Slot()
+						.FillWidth(2)
+						[
+							SNew(SComboBox<TSharedPtr<FName>>)
+							.OptionsSource(&NativeGeneratorItems)
+							.OnGenerateWidget_Lambda([](TSharedPtr<FName> Item)
+							{
+								return SNew(STextBlock).Text(FText::FromString(Item->IsNone() ? "Script Class" : Item->ToString()));
+							})
+							.OnSelectionChanged_Lambda([this](TSharedPtr<FName> InSelection, ESelectInfo::Type InSelectInfo)
+							{
+								if (!InSelection.IsValid()) return;
+								NativeGenerator = *InSelection;
+								NativeGeneratorTitleBlock->SetText(FText::FromString(NativeGenerator.IsNone() ? "Script Class" : NativeGenerator.ToString()));
+							})
+							.InitiallySelectedItem(NativeGeneratorItems[0])
+							[
+								SAssignNew(NativeGeneratorTitleBlock, STextBlock).Text(FText::FromString("Script Class"))
+							]
+						]
+						+ SHorizontalBox::Slot()
+						.FillWidth(3)
 						[
 							SNew(SObjectPropertyEntryBox)
+							.IsEnabled_Lambda([this]() { return NativeGenerator.IsNone(); })
 							.AllowedClass(UClass::StaticClass())
 							.AllowCreate(false)
 							.DisplayBrowse(true)
@@ -663,6 +757,34 @@ TSharedRef<SDockTab> FEditorWindowModule::OnSpawnPluginTab(const FSpawnTabArgs&
 			]
 			+ SScrollBox::Slot()
 			.Padding(10, 5)
+			[
+				SNew(SBorder)
+				.Content()
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.Padding(5, 5)
+					[
+						SNew(SCheckBox)
+						.IsChecked_Lambda([this]() {
+							return RecordUndo ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+						})
+						.OnCheckStateChanged_Lambda([this](ECheckBoxState State) {
+							RecordUndo = (State == ECheckBoxState::Checked);
+						})
+					]
+					+ SHorizontalBox::Slot()
+					.FillWidth(1)
+					.VAlign(VAlign_Center)
+					[
+						SNew(STextBlock)
+						.Text(FText::FromString(TEXT("Record Undo (disable for huge generation runs)")))
+					]
+				]
+			]
+			+ SScrollBox::Slot()
+			.Padding(10, 5)
 			[
 				SNew(SBorder)
 				.Content()
@@ -690,6 +812,51 @@ TSharedRef<SDockTab> FEditorWindowModule::OnSpawnPluginTab(const FSpawnTabArgs&
 					]
 				]
 			]
+			+ SScrollBox::Slot()
+			.Padding(10, 5)
+			[
+				SNew(SBorder)
+				.Content()
+				[
+					SNew(SVerticalBox)
+					+ SVerticalBox::Slot()
+					.Padding(0, 5)
+					[
+						SNew(STextBlock)
+						.Text(FText::FromString(TEXT("MANIFEST")))
+						.ColorAndOpacity(FColor(255, 255, 255, 40))
+						.Font(FCoreStyle::GetDefaultFontStyle("Bold", 20))
+						.Margin(FMargin(-2, -10))
+					]
+					+ SVerticalBox::Slot()
+					.Padding(10, 10)
+					[
+						SNew(SHorizontalBox)
+						+ SHorizontalBox::Slot()
+						.FillWidth(1)
+						.Padding(0, 0, 5, 0)
+						[
+							SNew(SButton)
+							.ContentPadding(FMargin(0))
+							.Text(FText::FromString("Save Manifest"))
+							.HAlign(HAlign_Center)
+							.VAlign(VAlign_Center)
+							.OnClicked_Raw(this, &FEditorWindowModule::SaveManifestButtonClicked)
+						]
+						+ SHorizontalBox::Slot()
+						.FillWidth(1)
+						.Padding(5, 0, 0, 0)
+						[
+							SNew(SButton)
+							.ContentPadding(FMargin(0))
+							.Text(FText::FromString("Apply Manifest"))
+							.HAlign(HAlign_Center)
+							.VAlign(VAlign_Center)
+							.OnClicked_Raw(this, &FEditorWindowModule::LoadManifestButtonClicked)
+						]
+					]
+				]
+			]
 		];
 }
 
@@ -737,128 +904,54 @@ bool FEditorWindowModule::CheckAndLog(bool Value, FString MessageToLog)
 	return Result;
 }
 
-FString FEditorWindowModule::ClearPathFormatting(FString InputString)
-{
-	FString PathFormat = "";
-	//remove level instancing postfix or asset path formatting
-	if (InputString.Contains("_LevelInstance_"))
-	{
-		TArray<FString> TempArray;
-		InputString.ParseIntoArray(TempArray, TEXT("_LevelInstance_"));
-		PathFormat = TempArray[0];
-	}
-	else if (InputString.Contains("."))
-	{
-		TArray<FString> TempArray;
-		InputString.ParseIntoArray(TempArray, TEXT("."));
-		PathFormat = TempArray[0];
-	}
-
-	//remove PIE renaming
-	if (InputString.Contains("UEDPIE_"))
-	{
-		if(PathFormat == "") PathFormat = InputString;
-
-		int32 BeginIndex = PathFormat.Find("UEDPIE");
-		int32 EndIndex = PathFormat.Find("_", ESearchCase::IgnoreCase, ESearchDir::FromStart, BeginIndex + 7); //UEDPIE_ has 7 characters
-		FString Crop = PathFormat.Mid(BeginIndex, EndIndex - BeginIndex + 1);
-
-		PathFormat.ReplaceInline(*(Crop), TEXT(""));
-	}
-
-	return PathFormat;
-}
-
 void FEditorWindowModule::ManualAddLevel(ULevel* Level)
 {
 	if (LevelsDataTable == nullptr) return;
 
-	bool LevelExistsInDataTable = false;
-
-	UWorld* AddedLevelWorld = (UWorld*)Level->GetOuter();
-	const TMap<FName, uint8*> DataTableRows = LevelsDataTable->GetRowMap();
-	TSet<FName> KeysSet;
-	int32 NrOfKeys = DataTableRows.GetKeys(KeysSet);
-
 	//check if the level exists in the datatable
-	for (int i = 0; i < NrOfKeys; i++)
-	{
-		FName RowName = KeysSet.Array()[i];
-		FLevelsStruct* RowData = LevelsDataTable->FindRow<FLevelsStruct>(RowName, "");
-
-		UWorld* DataTableWorld = RowData->World.LoadSynchronous();
-
-		if (DataTableWorld == AddedLevelWorld)
-		{
-			LevelExistsInDataTable = true;
-			break;
-		}
-	}
+	LevelIdentities.Update(LevelsDataTable);
+	bool LevelExistsInDataTable = LevelIdentities.FindRow(GeneratorSelection::GetPackageKey(Level->GetOutermost()->GetName())) != NAME_None;
 
 	if (!LevelExistsInDataTable) return;
 
-	//find the level stream
-	TArray<ULevelStreaming*> StreamingLevels = GEditor->GetEditorWorldContext().World()->GetStreamingLevels();
-	for (ULevelStreaming* StreamingLevel : StreamingLevels)
+	//find the level stream and rename it
+	if (ULevelStreaming* StreamingLevel = FLevelUtils::FindStreamingLevel(Level))
 	{
-		if (StreamingLevel->GetLoadedLevel() == Level)
-		{
-			//rename the stream
-			StreamingLevel->RenameForPIE(PIELevelNameCounter++);
-			break;
-		}
+		StreamingLevel->RenameForPIE(PIELevelNameCounter++);
 	}
 
 	//refresh the level browser
-	FEditorDelegates::RefreshLevelBrowser.Broadcast();
+	FLevelBrowserRefresh::Request();
 }
 
 void FEditorWindowModule::EditorMapChange(uint32 flags)
 {
 	ReplacementLevels.Empty();
+	GeneratedLevels.Empty();
 	ReplacementActors.Empty();
+	Manifest.Reset();
+	LevelIdentities.Invalidate();
+	TagIndex.MarkDirty();
 
-	//cleanup empty folders by rebooting worldbrowser module
-	FWorldBrowserModule& WBModule = FModuleManager::LoadModuleChecked<FWorldBrowserModule>("WorldBrowser");
-	TSharedPtr<FLevelCollectionModel> WorldModel = WBModule.SharedWorldModel(GEditor->GetEditorWorldContext().World());
-
-	WorldModel.Reset();
-	WBModule.ShutdownModule();
-	WBModule.StartupModule();
-
-	WBModule.OnBrowseWorld.Broadcast(GEditor->GetEditorWorldContext().World());
+	//the generator folders belonged to the previous world
+	GeneratedFolders.Empty();
+	FLevelBrowserRefresh::Cancel();
 }
 
 void FEditorWindowModule::RefreshLevels()
 {
 	if (CurrentlyDeleting) return;
 
-	for (TPair<ULevelStreaming*, TSet<ULevelStreaming*>> Level : ReplacementLevels)
-	{
-		// remove replacement levels if layout level has been removed manually
-		if (Level.Key->GetCurrentState() == ULevelStreaming::ECurrentState::Removed)
-		{
-			CurrentlyDeleting = true;
-			for (ULevelStreaming* ReplacementLevel : Level.Value)
-			{
-				UnloadFullLevel(ReplacementLevel);
-			}
-
-			ReplacementLevels.Remove(Level.Key);
-			CurrentlyDeleting = false;
-			break;
-		}
-
-		// remove replacement levels from the list if they have been removed manually
-		TSet<ULevelStreaming*> ReplacementLevels_I(Level.Value);
-		for (ULevelStreaming* ReplacementLevel : ReplacementLevels_I)
+	// only the levels removed since the last refresh are visited; replacement levels that were removed manually
+	// are just unregistered, a removed layout level takes its replacement levels with it
+	CurrentlyDeleting = true;
+	ReplacementLevels.ProcessRemovedLevels([](ULevelStreaming* LayoutLevel, const TSet<ULevelStreaming*>& Orphans) {
+		for (ULevelStreaming* ReplacementLevel : Orphans)
 		{
-			if (ReplacementLevel->GetCurrentState() == ULevelStreaming::ECurrentState::Removed)
-			{
-				ReplacementLevels[Level.Key].Remove(ReplacementLevel);
-			}
+			if (IsValid(ReplacementLevel) && ReplacementLevel->GetLoadedLevel()) UnloadFullLevel(ReplacementLevel);
 		}
-	}
+	});
+	CurrentlyDeleting = false;
 }
 
 void FEditorWindowModule::MoveAllActorsFromLevel(ULevelStreaming* LevelStream)
@@ -882,154 +975,336 @@ void FEditorWindowModule::MoveAllActorsFromLevel(ULevelStreaming* LevelStream)
 
 UClass* FEditorWindowModule::WeightedRandomActor(TSet<FWeightedActor> WeightedActors, FRandomStream& RandomStream, uint16 SumOfWeights)
 {
-	int32 RandomNumer = RandomStream.RandRange(0, SumOfWeights - 1);
-	UClass* ReplaceActorClass = nullptr;
+	const FWeightedActor* ReplaceActor = GeneratorSelection::WeightedRandom(WeightedActors, RandomStream, SumOfWeights);
+	UClass* ReplaceActorClass = ReplaceActor ? ReplaceActor->Actor.Get() : nullptr;
+	ensure(ReplaceActorClass);
+
+	return ReplaceActorClass;
+}
+
+FManifestLevelRef FEditorWindowModule::MakeLevelRef(ULevel* Level)
+{
+	if (FManifestLevelRef* CachedRef = LevelRefs.Find(Level)) return *CachedRef;
+
+	// actors in the persistent level get the default (NAME_None) reference
+	ULevelStreaming* LevelStream = FLevelUtils::FindStreamingLevel(Level);
+	FManifestLevelRef LevelRef = LevelStream ? GeneratorSelection::MakeLevelRef(GEditor->GetEditorWorldContext().World(), LevelStream) : FManifestLevelRef();
+
+	return LevelRefs.Add(Level, LevelRef);
+}
+
+void FEditorWindowModule::SpawnReplacementActors(const TArray<AActor*>& SourceActors, const TArray<FActorSpawnRequest>& SpawnRequests)
+{
+	if (SpawnRequests.Num() == 0) return;
+
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_ReplacementSpawning);
 
-	for (FWeightedActor RowReplaceActor : WeightedActors)
+	const double StartTime = FPlatformTime::Seconds();
+
+	TagIndex.SuspendUpdates();
+	TArray<AActor*> SpawnedActors = FBulkActorSpawner::SpawnActors(GEditor->GetEditorWorldContext().World(), SpawnRequests);
+	TagIndex.ResumeUpdates(SpawnedActors);
+
+	for (int32 Index = 0; Index < SpawnedActors.Num(); Index++)
 	{
-		if (RandomNumer < RowReplaceActor.Weight)
+		if (SpawnedActors[Index]) AddReplacementActor(SourceActors[Index], SpawnedActors[Index], SpawnRequests[Index].Class);
+	}
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogEditorWindow, Log, TEXT("Spawned %d replacement actors in %.2f ms (%.0f actors/s)"),
+		SpawnedActors.Num(), Seconds * 1000.0, SpawnedActors.Num() / FMath::Max(Seconds, UE_SMALL_NUMBER));
+}
+
+void FEditorWindowModule::AddReplacementActor(AActor* SourceActor, AActor* ReplacementActor, UClass* ReplaceActorClass)
+{
+	TPair<AActor*, AActor*> Pair;
+	Pair.Key = SourceActor;
+	Pair.Value = ReplacementActor;
+	ReplacementActors.Add(Pair);
+
+	FManifestActorEntry Entry;
+	Entry.Level = MakeLevelRef(SourceActor->GetLevel());
+	Entry.SourceActorName = SourceActor->GetFName();
+	Entry.ReplaceActorClassPath = ReplaceActorClass->GetPathName();
+	Entry.Transform = SourceActor->GetTransform();
+	Manifest.SetActor(Entry);
+}
+
+void FEditorWindowModule::UnloadReplacementLevels(UDataTable* InLevelsDataTable)
+{
+	if (InLevelsDataTable) LevelIdentities.Update(InLevelsDataTable);
+
+	// the layout levels the pass replaces again; a row where every weight is zero keeps its replacements
+	TArray<ULevelStreaming*> LayoutLevels;
+	for (const TPair<ULevelStreaming*, TSet<ULevelStreaming*>>& ReplacementLevel : ReplacementLevels.GetAll())
+	{
+		if (InLevelsDataTable)
 		{
-			ReplaceActorClass = RowReplaceActor.Actor;
-			break;
+			const FLevelsStruct* RowData = InLevelsDataTable->FindRow<FLevelsStruct>(LevelIdentities.FindRow(ReplacementLevel.Key), "", false);
+			if (RowData == nullptr || GeneratorSelection::SumOfWeights(RowData->ReplaceWorlds) == 0) continue;
 		}
-		RandomNumer -= RowReplaceActor.Weight;
+		LayoutLevels.Add(ReplacementLevel.Key);
 	}
-	ensure(ReplaceActorClass);
+	if (LayoutLevels.Num() == 0) return;
 
-	return ReplaceActorClass;
+	CurrentlyDeleting = true;
+	for (ULevelStreaming* LayoutLevel : LayoutLevels)
+	{
+		for (ULevelStreaming* CreatedReplacementLevel : ReplacementLevels.RemoveLayout(LayoutLevel))
+		{
+			UnloadFullLevel(CreatedReplacementLevel);
+		}
+	}
+	CurrentlyDeleting = false;
+
+	// one collection for all removed replacement levels
+	ForceGarbageCollection();
 }
 
+void FEditorWindowModule::ApplyManifest(const FGenerationManifest& InManifest)
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_ApplyManifest);
 
+	// the recorded choices still apply if the datatables changed, but a fresh run may give a different result
+	if (LevelsDataTable && InManifest.LevelsDataTableHash != FGenerationManifest::HashDataTable(LevelsDataTable))
+		UE_LOG(LogEditorWindow, Warning, TEXT("Levels DataTable has changed since the manifest was saved."));
+	if (TagsDataTable && InManifest.TagsDataTableHash != FGenerationManifest::HashDataTable(TagsDataTable))
+		UE_LOG(LogEditorWindow, Warning, TEXT("Tags DataTable has changed since the manifest was saved."));
+	if (ActorsDataTable && InManifest.ActorsDataTableHash != FGenerationManifest::HashDataTable(ActorsDataTable))
+		UE_LOG(LogEditorWindow, Warning, TEXT("Actors DataTable has changed since the manifest was saved."));
 
-// BUTTON FUNCTIONS
-FReply FEditorWindowModule::GenerateLevelsButtonClicked()
+	//clear the current generation result
+	for (TPair<AActor*, AActor*> ReplacementActor : ReplacementActors)
+	{
+		if (IsValid(ReplacementActor.Value)) ReplacementActor.Value->Destroy();
+	}
+	ReplacementActors.Empty();
+
+	UnloadReplacementLevels(nullptr);
+
+	LevelRefs.Empty();
+	Manifest = InManifest;
+	Manifest.Actors.Empty();
+
+	for (const FManifestLevelEntry& Entry : InManifest.Levels)
+	{
+		ULevelStreaming* LayoutLevel = GeneratorSelection::ResolveLevelRef(GEditor->GetEditorWorldContext().World(), Entry.LayoutLevel);
+		UWorld* ReplaceWorld = LoadObject<UWorld>(nullptr, *Entry.ReplaceWorldPath);
+		if (LayoutLevel == nullptr || ReplaceWorld == nullptr)
+		{
+			UE_LOG(LogEditorWindow, Warning, TEXT("Manifest level '%s' could not be applied."), *Entry.ReplaceWorldPath);
+			continue;
+		}
+
+		ReplacementLevels.Add(LayoutLevel, LoadFullLevel(ReplaceWorld, Entry.Transform, Entry.FolderName, Entry.Color));
+	}
+
+	//load the new levels so their actors can be found
+	GEditor->GetEditorWorldContext().World()->UpdateLevelStreaming();
+
+	// the recorded replacements are spawned in one batch, like the actors pass does
+	TArray<AActor*> SourceActors;
+	TArray<FActorSpawnRequest> SpawnRequests;
+	SourceActors.Reserve(InManifest.Actors.Num());
+	SpawnRequests.Reserve(InManifest.Actors.Num());
+
+	for (const FManifestActorEntry& Entry : InManifest.Actors)
+	{
+		ULevelStreaming* LevelStream = GeneratorSelection::ResolveLevelRef(GEditor->GetEditorWorldContext().World(), Entry.Level);
+		ULevel* Level = Entry.Level.PackageKey.IsNone() ? GEditor->GetEditorWorldContext().World()->PersistentLevel.Get()
+														 : (LevelStream ? LevelStream->GetLoadedLevel() : nullptr);
+		AActor* SourceActor = Level ? FindObjectFast<AActor>(Level, Entry.SourceActorName) : nullptr;
+		UClass* ReplaceActorClass = LoadObject<UClass>(nullptr, *Entry.ReplaceActorClassPath);
+		if (SourceActor == nullptr || ReplaceActorClass == nullptr)
+		{
+			UE_LOG(LogEditorWindow, Warning, TEXT("Manifest actor '%s' could not be applied."), *Entry.SourceActorName.ToString());
+			continue;
+		}
+
+		SourceActors.Add(SourceActor);
+		SpawnRequests.Add({ ReplaceActorClass, Entry.Transform, Level });
+	}
+
+	SpawnReplacementActors(SourceActors, SpawnRequests);
+}
+
+void FEditorWindowModule::RunNativeGenerator()
 {
-	if (CheckAndLog(LevelsDataTable == nullptr, "Levels DataTable is empty!")) return FReply::Handled();
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_NativeGenerator);
 
-	// Initialize rng with seed
-	FRandomStream RandomStream;
+	const IDungeonGenerator* Generator = FDungeonGeneratorRegistry::Get().Find(NativeGenerator);
+	if (CheckAndLog(Generator == nullptr, "Generator not found!")) return;
+	if (CheckAndLog(LevelsDataTable == nullptr, "Levels DataTable is empty!")) return;
+
+	// the native generators use the levels seed
 	if (RandomizeLevelsSeed) {
+		FRandomStream RandomStream;
 		RandomStream.GenerateNewSeed();
 		LevelsSeedNum = RandomStream.GetCurrentSeed();
 	}
-	else {
-		RandomStream.Initialize(LevelsSeedNum);
+
+	FDungeonGeneratorInput Input;
+	Input.LevelsDataTable = LevelsDataTable;
+	Input.TagsDataTable = TagsDataTable;
+	Input.ActorsDataTable = ActorsDataTable;
+	Input.Seed = LevelsSeedNum;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FDungeonLayout Layout;
+	if (CheckAndLog(!Generator->Generate(Input, Layout), "Generator could not build a layout!")) return;
+
+	UE_LOG(LogEditorWindow, Log, TEXT("%s: %d rooms, %d connections in %.2f ms"), *NativeGenerator.ToString(),
+		Layout.Rooms.Num(), Layout.Connections.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	// the old levels are unloaded before the transaction opens, removing a level isn't recorded anyway
+	UPluginAPI::ClearAllLevels();
+
+	FGeneratorTransaction Transaction(LOCTEXT("RunNativeGenerator", "Run Native Generator"), RecordUndo);
+
+	TArray<FLayoutRoom> Rooms;
+	Rooms.Reserve(Layout.Rooms.Num());
+	for (const FDungeonLayoutRoom& LayoutRoom : Layout.Rooms)
+	{
+		FLayoutRoom& Room = Rooms.AddDefaulted_GetRef();
+		Room.LevelPath = LayoutRoom.World.ToSoftObjectPath().ToString();
+		Room.Position = LayoutRoom.Transform.GetLocation();
+		Room.Rotation = LayoutRoom.Transform.Rotator();
 	}
 
+	const TArray<FSpawnedRoom> SpawnedRooms = UPluginAPI::SpawnLayout(Rooms);
+	UPluginAPI::ConnectLayout(SpawnedRooms, Layout.Connections);
+}
+
+
+
+// GENERATOR PASSES
+void FEditorWindowModule::GenerateLevels(UDataTable* InLevelsDataTable, int32 Seed)
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_GenerateLevels);
+
+	LevelRefs.Empty();
+	Manifest.LevelsSeed = Seed;
+	Manifest.LevelsDataTableHash = FGenerationManifest::HashDataTable(InLevelsDataTable);
+
 	//clear all reaplacement actors
 	for (TPair<AActor*, AActor*> ReplacementActor : ReplacementActors)
 	{
 		ReplacementActor.Value->Destroy();
-		GEditor->ForceGarbageCollection(true);
+		ForceGarbageCollection();
 	}
 	ReplacementActors.Empty();
+	Manifest.Actors.Empty();
 
-	const TMap<FName, uint8*> DataTableRows = LevelsDataTable->GetRowMap();
+	// nothing left to unload when the button already did it before its transaction
+	UnloadReplacementLevels(InLevelsDataTable);
 
-	// for each streamed level
-	const TArray<ULevelStreaming*> StreamedLevels = GWorld->GetStreamingLevels();
+	// selection: layout levels that have a row (a snapshot, replacing levels adds and removes streaming levels)
+	TArray<FLevelReplacementSlot> Slots;
+	const TArray<ULevelStreaming*> StreamedLevels = GEditor->GetEditorWorldContext().World()->GetStreamingLevels();
 	for(ULevelStreaming* StreamedLevel : StreamedLevels)
 	{
-		//if the level was already removed, skip
-		if (StreamedLevel->GetCurrentState() == ULevelStreaming::ECurrentState::Removed ||
-			StreamedLevel->GetCurrentState() == ULevelStreaming::ECurrentState::Unloaded ||
-			!IsValid(StreamedLevel)) continue;
+		//only layout levels get replaced; skip generated levels and levels that were already removed
+		if (GeneratedLevels.Contains(StreamedLevel) || !FGeneratedLevelIndex::IsLive(StreamedLevel)) continue;
 
-		// for each row
-		for (TPair<FName, uint8*> Row : DataTableRows)
+		// find the row of the level by its package
+		FLevelsStruct* RowData = nullptr;
 		{
-			// parse row data
-			FLevelsStruct* RowData = (FLevelsStruct*)Row.Value;
-			RowData->World.LoadSynchronous();
-			UWorld* RowWorld = RowData->World.Get();
-			TSet<FWeightedWorld> RowReplaceWorlds = RowData->ReplaceWorlds;
-
-			// find the correct row
-			FString InstancedLevelPath = ClearPathFormatting(StreamedLevel->GetLoadedLevel()->GetOuter()->GetPathName());
-			FString DataTableLevelPath = ClearPathFormatting(RowWorld->GetPathName());
-			if (InstancedLevelPath == DataTableLevelPath)
-			{
-				// calculate the sum of all weights for the level
-				uint16 SumOfWeights = 0;
-				for (FWeightedWorld ReplaceWorld : RowReplaceWorlds)
-				{
-					SumOfWeights += ReplaceWorld.Weight;
-				}
+			DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_RowLookup);
+			RowData = InLevelsDataTable->FindRow<FLevelsStruct>(LevelIdentities.FindRow(StreamedLevel), "", false);
+		}
+		if (RowData == nullptr) continue;
 
-				//check if all row replacements' weights are zero
-				if (CheckAndLog(SumOfWeights == 0,
-					"All replacement worlds listed under the '" + DataTableLevelPath + "' row have a weight value of zero. No replacement world will be generated!")) continue;
+		const int32 SumOfWeights = GeneratorSelection::SumOfWeights(RowData->ReplaceWorlds);
 
-				// If level already has replacement levels, delete them
-				for (TPair<ULevelStreaming*, TSet<ULevelStreaming*>> ReplacementLevel : ReplacementLevels)
-				{
-					if (ReplacementLevel.Key == StreamedLevel)
-					{
-						//remove all reaplacement levels
-						for (ULevelStreaming* CreatedReplacementLevel : ReplacementLevel.Value)
-						{
-							UnloadFullLevel(CreatedReplacementLevel);
-						}
-						ReplacementLevels.Remove(StreamedLevel);
-
-						GEditor->ForceGarbageCollection(true);
-						break;
-					}
-				}
+		//check if all row replacements' weights are zero
+		if (CheckAndLog(SumOfWeights == 0,
+			"All replacement worlds listed under the '" + RowData->World.ToSoftObjectPath().GetLongPackageName() + "' row have a weight value of zero. No replacement world will be generated!")) continue;
 
+		FLevelReplacementSlot& Slot = Slots.AddDefaulted_GetRef();
+		Slot.LayoutLevel = StreamedLevel;
+		Slot.RowData = RowData;
+		Slot.SumOfWeights = SumOfWeights;
+	}
 
-				// Choose new replacement level
-				int32 RandomNumer = RandomStream.RandRange(0, SumOfWeights-1);
-				UWorld* ReplaceWorld = nullptr;
-				for (FWeightedWorld RowReplaceWorld : RowReplaceWorlds)
-				{
-					if (RandomNumer < RowReplaceWorld.Weight)
-					{
-						ReplaceWorld = RowReplaceWorld.World.LoadSynchronous();
-						break;
-					}
-					RandomNumer -= RowReplaceWorld.Weight;
-				}
-				ensure(ReplaceWorld);
+	// the levels are referenced by package and occurrence, taken once the old replacements are gone
+	const TMap<const ULevelStreaming*, FManifestLevelRef> LayoutRefs = GeneratorSelection::MakeLevelRefs(GEditor->GetEditorWorldContext().World());
 
-				// name the replacement level folder with the same name as the layout level
-				TArray<FString> Parse;
-				StreamedLevel->GetWorldAssetPackageName().ParseIntoArray(Parse, TEXT("/"));
-				FString FolderName = Parse[Parse.Num() - 1];
+	// choose the replacement worlds in parallel, each layout level draws from its own stream
+	{
+		DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_LevelSelection);
 
-				TSet<ULevelStreaming*> ReplacementLevelsStreams = LoadFullLevel(ReplaceWorld,
-																			    StreamedLevel->LevelTransform,
-																			    FolderName,
-																			    StreamedLevel->LevelColor);
+		ParallelFor(Slots.Num(), [&Slots, &LayoutRefs, Seed](int32 Index)
+		{
+			FLevelReplacementSlot& Slot = Slots[Index];
+			Slot.LayoutRef = LayoutRefs.FindRef(Slot.LayoutLevel);
 
-				TPair<ULevelStreaming*, TSet<ULevelStreaming*>> Pair;
-				Pair.Key = StreamedLevel;
-				Pair.Value = ReplacementLevelsStreams;
-				ReplacementLevels.Add(Pair);
+			FRandomStream LevelRandomStream = GeneratorSelection::MakeLevelRandomStream(Seed, Slot.LayoutRef);
+			const FWeightedWorld* Pick = GeneratorSelection::WeightedRandom(Slot.RowData->ReplaceWorlds, LevelRandomStream, Slot.SumOfWeights);
+			if (Pick) Slot.ReplaceWorld = Pick->World;
+		});
+	}
 
-				break;
-			}
+	// start loading all chosen worlds at once, then wait for them together
+	{
+		DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_WorldLoad);
+
+		TSet<FString> PackagesToLoad;
+		for (const FLevelReplacementSlot& Slot : Slots)
+		{
+			if (!Slot.ReplaceWorld.IsNull() && Slot.ReplaceWorld.Get() == nullptr) PackagesToLoad.Add(Slot.ReplaceWorld.ToSoftObjectPath().GetLongPackageName());
+		}
+
+		for (const FString& PackageName : PackagesToLoad)
+		{
+			LoadPackageAsync(PackageName);
 		}
+
+		if (PackagesToLoad.Num() != 0) FlushAsyncLoading();
 	}
 
-	return FReply::Handled();
+	// instancing, on the game thread in layout order
+	for (const FLevelReplacementSlot& Slot : Slots)
+	{
+		ULevelStreaming* StreamedLevel = Slot.LayoutLevel;
+		UWorld* ReplaceWorld = Slot.ReplaceWorld.LoadSynchronous();
+		if (!ensure(ReplaceWorld)) continue;
+
+		// name the replacement level folder with the same name as the layout level
+		TArray<FString> Parse;
+		StreamedLevel->GetWorldAssetPackageName().ParseIntoArray(Parse, TEXT("/"));
+		FString FolderName = Parse[Parse.Num() - 1];
+
+		TSet<ULevelStreaming*> ReplacementLevelsStreams = LoadFullLevel(ReplaceWorld,
+																	    StreamedLevel->LevelTransform,
+																	    FolderName,
+																	    StreamedLevel->LevelColor);
+
+		ReplacementLevels.Add(StreamedLevel, ReplacementLevelsStreams);
+
+		FManifestLevelEntry Entry;
+		Entry.LayoutLevel = Slot.LayoutRef;
+		Entry.ReplaceWorldPath = ReplaceWorld->GetPathName();
+		Entry.FolderName = FolderName;
+		Entry.Transform = StreamedLevel->LevelTransform;
+		Entry.Color = StreamedLevel->LevelColor;
+		Manifest.SetLevel(Entry);
+	}
 }
 
-FReply FEditorWindowModule::GenerateTagsButtonClicked()
+void FEditorWindowModule::GenerateTags(UDataTable* InTagsDataTable, int32 Seed)
 {
-	if (CheckAndLog(TagsDataTable == nullptr, "Tags DataTable is empty!")) return FReply::Handled();
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_GenerateTags);
 
-	// Initialize rng with seed
-	FRandomStream RandomStream;
-	if (RandomizeTagsSeed) {
-		RandomStream.GenerateNewSeed();
-		TagsSeedNum = RandomStream.GetCurrentSeed();
-	}
-	else {
-		RandomStream.Initialize(TagsSeedNum);
-	}
+	FRandomStream RandomStream(Seed);
 
-	const TMap<FName, uint8*> DataTableRows = TagsDataTable->GetRowMap();
+	LevelRefs.Empty();
+	Manifest.TagsSeed = Seed;
+	Manifest.TagsDataTableHash = FGenerationManifest::HashDataTable(InTagsDataTable);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	const TMap<FName, uint8*>& DataTableRows = InTagsDataTable->GetRowMap();
 	for (TPair<FName, uint8*> Row : DataTableRows)
 	{
 		// parse row data
@@ -1039,26 +1314,32 @@ FReply FEditorWindowModule::GenerateTagsButtonClicked()
 		uint8 NumberOfElements = RowData->NumberOfElements;
 		UClass* ReplaceActorClass = RowData->ReplaceActor;
 
-		TArray<AActor*> FoundActors;
-		UGameplayStatics::GetAllActorsWithTag(GEditor->GetEditorWorldContext().World(), ActorTag, FoundActors);
-
-		if (FoundActors.Num() == 0) continue;
-
-		if (CheckAndLog(FoundActors.Num() < NumberOfElements,
-			"Tag '" + ActorTag.ToString() + "' has less than " + FString::FromInt(NumberOfElements) + " actors in the level!")) continue;
-
+		// tagged actors grouped per level, from the tag index. copied: the lists are shuffled and actors are
+		// destroyed while they are iterated, which would change the index under us
 		TMap<ULevel*, TArray<AActor*>> ActorsInLevels;
+		if (const TMap<ULevel*, TArray<AActor*>>* IndexedActors = TagIndex.FindActorsByLevel(GEditor->GetEditorWorldContext().World(), ActorTag))
+		{
+			ActorsInLevels = *IndexedActors;
+		}
 
-		for (AActor* FoundActor : FoundActors)
+		int32 NumFoundActors = 0;
+		for (const TPair<ULevel*, TArray<AActor*>>& ActorsInLevel : ActorsInLevels)
 		{
-			ULevel* Level = FoundActor->GetLevel();
-			TArray<AActor*>& Array = ActorsInLevels.FindOrAdd(Level);
-			Array.Add(FoundActor);
+			NumFoundActors += ActorsInLevel.Value.Num();
 		}
 
-		for (TPair<ULevel*, TArray<AActor*>> ActorsInLevel : ActorsInLevels)
+		if (NumFoundActors == 0) continue;
+
+		if (CheckAndLog(NumFoundActors < NumberOfElements,
+			"Tag '" + ActorTag.ToString() + "' has less than " + FString::FromInt(NumberOfElements) + " actors in the level!")) continue;
+
+		// replacements of the whole row are spawned in one batch
+		TArray<AActor*> SourceActors;
+		TArray<FActorSpawnRequest> SpawnRequests;
+
+		for (TPair<ULevel*, TArray<AActor*>>& ActorsInLevel : ActorsInLevels)
 		{
-			TArray<AActor*> FoundActorsInLevel = ActorsInLevel.Value;
+			TArray<AActor*>& FoundActorsInLevel = ActorsInLevel.Value;
 
 			//remove all replacement actors
 			for (AActor* FoundActor : FoundActorsInLevel)
@@ -1079,9 +1360,10 @@ FReply FEditorWindowModule::GenerateTagsButtonClicked()
 						//delete the replacement actor
 						ReplacementActor.Value->Destroy();
 
-						GEditor->ForceGarbageCollection(true);
+						ForceGarbageCollection();
 
 						ReplacementActors.Remove(ReplacementActor.Key);
+						Manifest.RemoveActor(MakeLevelRef(ReplacementActor.Key->GetLevel()), ReplacementActor.Key->GetFName());
 					}
 
 					if (ReplacementActor.Key->GetClass() == ReplaceActorClass)
@@ -1089,56 +1371,45 @@ FReply FEditorWindowModule::GenerateTagsButtonClicked()
 						//delete its replacement actor
 						ReplacementActor.Value->Destroy();
 
-						GEditor->ForceGarbageCollection(true);
+						ForceGarbageCollection();
 
 						ReplacementActors.Remove(ReplacementActor.Key);
+						Manifest.RemoveActor(MakeLevelRef(ReplacementActor.Key->GetLevel()), ReplacementActor.Key->GetFName());
 					}
 				}
 			}
 
-			//filter random number of actors
-			uint8 NumberOfActorsToRemove = FoundActorsInLevel.Num() - NumberOfElements;
-			for (int i = 0; i < NumberOfActorsToRemove; i++)
-			{
-				int32 RandomActorToRemoveIndex = RandomStream.RandRange(0, FoundActorsInLevel.Num() - 1);
-				FoundActorsInLevel.RemoveAt(RandomActorToRemoveIndex);
-			}
+			//pick a random subset of the actors, they end up at the front of the array
+			const int32 NumSelected = GeneratorSelection::SelectRandomSubset(FoundActorsInLevel, NumberOfElements, RandomStream);
 
-			//spawn replacement actor
-			for (AActor* FoundActor : FoundActorsInLevel)
+			//queue replacement actor
+			for (int32 Index = 0; Index < NumSelected; Index++)
 			{
-				FActorSpawnParameters SpawnParams;
-				SpawnParams.OverrideLevel = FoundActor->GetLevel();
-				AActor* ReplacementActor = GEditor->GetEditorWorldContext().World()->SpawnActor<AActor>(ReplaceActorClass, FoundActor->GetTransform(), SpawnParams);
-
-				TPair<AActor*, AActor*> Pair;
-				Pair.Key = FoundActor;
-				Pair.Value = ReplacementActor;
-				ReplacementActors.Add(Pair);
+				AActor* FoundActor = FoundActorsInLevel[Index];
+				SourceActors.Add(FoundActor);
+				SpawnRequests.Add({ ReplaceActorClass, FoundActor->GetTransform(), FoundActor->GetLevel() });
 			}
 		}
+
+		SpawnReplacementActors(SourceActors, SpawnRequests);
 	}
 
-	return FReply::Handled();
+	UE_LOG(LogEditorWindow, Log, TEXT("Tags pass: %d rows in %.2f ms"), DataTableRows.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
 }
 
-FReply FEditorWindowModule::GenerateActorsButtonClicked()
+void FEditorWindowModule::GenerateActors(UDataTable* InActorsDataTable, int32 Seed)
 {
-	if (CheckAndLog(ActorsDataTable == nullptr, "Actors DataTable is empty!")) return FReply::Handled();
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_GenerateActors);
 
-	// Initialize rng with seed
-	FRandomStream RandomStream;
-	if (RandomizeActorsSeed) {
-		RandomStream.GenerateNewSeed();
-		ActorsSeedNum = RandomStream.GetCurrentSeed();
-	}
-	else {
-		RandomStream.Initialize(ActorsSeedNum);
-	}
+	FRandomStream RandomStream(Seed);
+
+	LevelRefs.Empty();
+	Manifest.ActorsSeed = Seed;
+	Manifest.ActorsDataTableHash = FGenerationManifest::HashDataTable(InActorsDataTable);
 
 	TArray<AActor*> FoundActors;
 
-	const TMap<FName, uint8*> DataTableRows = ActorsDataTable->GetRowMap();
+	const TMap<FName, uint8*>& DataTableRows = InActorsDataTable->GetRowMap();
 	for (TPair<FName, uint8*> Row : DataTableRows)
 	{
 		// parse row data
@@ -1159,6 +1430,12 @@ FReply FEditorWindowModule::GenerateActorsButtonClicked()
 
 		UGameplayStatics::GetAllActorsOfClass(GEditor->GetEditorWorldContext().World(), RowClass, FoundActors);
 
+		// replacements of the whole row are spawned in one batch
+		TArray<AActor*> SourceActors;
+		TArray<FActorSpawnRequest> SpawnRequests;
+		SourceActors.Reserve(FoundActors.Num());
+		SpawnRequests.Reserve(FoundActors.Num());
+
 		//remove replacement actors
 		for (AActor* Actor : FoundActors)
 		{
@@ -1178,26 +1455,23 @@ FReply FEditorWindowModule::GenerateActorsButtonClicked()
 					//delete the replacement actor
 					ReplacementActor.Value->Destroy();
 
-					GEditor->ForceGarbageCollection(true);
+					ForceGarbageCollection();
 
 					ReplacementActors.Remove(ReplacementActor.Key);
+					Manifest.RemoveActor(MakeLevelRef(Actor->GetLevel()), Actor->GetFName());
 				}
 			}
 
 			// select a replacement actor
 			UClass* ReplaceActorClass = WeightedRandomActor(RowReplaceActors, RandomStream, SumOfWeights);
 
-			//spawn the replacement actor
-			FActorSpawnParameters SpawnParams;
-			SpawnParams.OverrideLevel = Actor->GetLevel();
-			AActor* ReplacementActor = GEditor->GetEditorWorldContext().World()->SpawnActor<AActor>(ReplaceActorClass, Actor->GetTransform(), SpawnParams);
-
-			TPair<AActor*, AActor*> Pair;
-			Pair.Key = Actor;
-			Pair.Value = ReplacementActor;
-			ReplacementActors.Add(Pair);
+			//queue the replacement actor
+			SourceActors.Add(Actor);
+			SpawnRequests.Add({ ReplaceActorClass, Actor->GetTransform(), Actor->GetLevel() });
 		}
 
+		SpawnReplacementActors(SourceActors, SpawnRequests);
+
 		/*
 		if (RowData->bVariableSpawnPoint)
 		{
@@ -1220,17 +1494,13 @@ FReply FEditorWindowModule::GenerateActorsButtonClicked()
 				if(CheckAndLog(TaggedActors.Num() < ElementTag.Value,
 					"Tag '" + ElementTag.Key.ToString() + "' has less than " + FString::FromInt(ElementTag.Value) + " actors in the level!")) continue;
 
-				//filter random number of actors
-				uint8 NumberOfActorsToRemove = TaggedActors.Num() - ElementTag.Value;
-				for (int i = 0; i < NumberOfActorsToRemove; i++)
-				{
-					int32 RandomActorToRemoveIndex = RandomStream.RandRange(0, TaggedActors.Num() - 1);
-					TaggedActors.RemoveAt(RandomActorToRemoveIndex);
-				}
+				//pick a random subset of the actors, they end up at the front of the array
+				const int32 NumSelected = GeneratorSelection::SelectRandomSubset(TaggedActors, ElementTag.Value, RandomStream);
 
 				//spawn replacement actor
-				for (AActor* TaggedActor : TaggedActors)
+				for (int32 Index = 0; Index < NumSelected; Index++)
 				{
+					AActor* TaggedActor = TaggedActors[Index];
 					// select a replacement actor
 					UClass* ReplaceActorClass = WeightedRandomActor(RowReplaceActors, RandomStream, SumOfWeights);
 
@@ -1249,62 +1519,129 @@ FReply FEditorWindowModule::GenerateActorsButtonClicked()
 		*/
 
 	}
+}
+
+
+
+// BUTTON FUNCTIONS
+FReply FEditorWindowModule::GenerateLevelsButtonClicked()
+{
+	if (CheckAndLog(LevelsDataTable == nullptr, "Levels DataTable is empty!")) return FReply::Handled();
+
+	// the old replacement levels are unloaded before the transaction opens, removing a level resets the undo buffer
+	UnloadReplacementLevels(LevelsDataTable);
+
+	FGeneratorTransaction Transaction(LOCTEXT("GenerateLevels", "Generate Levels"), RecordUndo);
+
+	// Initialize the seed, every layout level draws from a stream derived from it
+	if (RandomizeLevelsSeed) {
+		FRandomStream RandomStream;
+		RandomStream.GenerateNewSeed();
+		LevelsSeedNum = RandomStream.GetCurrentSeed();
+	}
+
+	GenerateLevels(LevelsDataTable, LevelsSeedNum);
+
+	return FReply::Handled();
+}
+
+FReply FEditorWindowModule::GenerateTagsButtonClicked()
+{
+	if (CheckAndLog(TagsDataTable == nullptr, "Tags DataTable is empty!")) return FReply::Handled();
+
+	FGeneratorTransaction Transaction(LOCTEXT("GenerateTags", "Generate Tags"), RecordUndo);
+
+	// the truncated value is used so the displayed seed reproduces this run
+	if (RandomizeTagsSeed) {
+		FRandomStream RandomStream;
+		RandomStream.GenerateNewSeed();
+		TagsSeedNum = RandomStream.GetCurrentSeed();
+	}
+
+	GenerateTags(TagsDataTable, TagsSeedNum);
+
+	return FReply::Handled();
+}
+
+FReply FEditorWindowModule::GenerateActorsButtonClicked()
+{
+	if (CheckAndLog(ActorsDataTable == nullptr, "Actors DataTable is empty!")) return FReply::Handled();
+
+	FGeneratorTransaction Transaction(LOCTEXT("GenerateActors", "Generate Actors"), RecordUndo);
+
+	// the truncated value is used so the displayed seed reproduces this run
+	if (RandomizeActorsSeed) {
+		FRandomStream RandomStream;
+		RandomStream.GenerateNewSeed();
+		ActorsSeedNum = RandomStream.GetCurrentSeed();
+	}
+
+	GenerateActors(ActorsDataTable, ActorsSeedNum);
 
 	return FReply::Handled();
 }
 
 FReply FEditorWindowModule::MergeButtonClicked()
 {
-	// for each streamed level
-	const TArray<ULevelStreaming*> StreamedLevels = GWorld->GetStreamingLevels();
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_Merge);
 
-	for (ULevelStreaming* StreamedLevel : StreamedLevels)
+	// the live generated levels from the index, plus the loaded layout levels
+	TArray<ULevelStreaming*> StreamedLevels = GeneratedLevels.GetLiveLevels();
+	for (ULevelStreaming* StreamedLevel : GWorld->GetStreamingLevels())
 	{
-		//move all actors from the level
-		if (StreamedLevel->GetCurrentState() == ULevelStreaming::ECurrentState::Removed ||
-			StreamedLevel->GetCurrentState() == ULevelStreaming::ECurrentState::Unloaded ||
-			!IsValid(StreamedLevel)) continue;
-		MoveAllActorsFromLevel(StreamedLevel);
-		//UnloadFullLevel(StreamedLevel);
-		//CleanupFolders();
+		if (!GeneratedLevels.Contains(StreamedLevel) && FGeneratedLevelIndex::IsLive(StreamedLevel)) StreamedLevels.Add(StreamedLevel);
 	}
 
-	//delete all actor spawnpoints via their tags
-	const TMap<FName, uint8*> DataTableRows = TagsDataTable->GetRowMap();
-	for (TPair<FName, uint8*> Row : DataTableRows)
+	// the merged levels are removed once the transaction is closed, removing a level resets the undo buffer
 	{
-		// parse row data
-		FTagsStruct* RowData = (FTagsStruct*)Row.Value;
+		FGeneratorTransaction Transaction(LOCTEXT("MergeLevels", "Merge Generated Levels"), RecordUndo);
 
-		FName ActorTag = RowData->ActorTag;
+		for (ULevelStreaming* StreamedLevel : StreamedLevels)
+		{
+			//move all actors from the level
+			MoveAllActorsFromLevel(StreamedLevel);
+			//UnloadFullLevel(StreamedLevel);
+			//CleanupFolders();
+		}
 
-		TArray<AActor*> FoundActors;
-		UGameplayStatics::GetAllActorsWithTag(GEditor->GetEditorWorldContext().World(), ActorTag, FoundActors);
+		// actors changed level, the tag index has to be rebuilt
+		TagIndex.MarkDirty();
 
-		for (AActor* FoundActor : FoundActors)
+		//delete all actor spawnpoints via their tags
+		const double StartTime = FPlatformTime::Seconds();
+		const TMap<FName, uint8*> DataTableRows = TagsDataTable->GetRowMap();
+		for (TPair<FName, uint8*> Row : DataTableRows)
 		{
-			FoundActor->Destroy();
+			// parse row data
+			FTagsStruct* RowData = (FTagsStruct*)Row.Value;
+
+			FName ActorTag = RowData->ActorTag;
+
+			TArray<AActor*> FoundActors = TagIndex.GetActors(GEditor->GetEditorWorldContext().World(), ActorTag);
+
+			for (AActor* FoundActor : FoundActors)
+			{
+				FoundActor->Destroy();
+			}
 		}
-	}
+		UE_LOG(LogEditorWindow, Log, TEXT("Merge: removed spawn points of %d tags in %.2f ms"), DataTableRows.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
 
-	for (TPair<AActor*, AActor*> ReplacementActor : ReplacementActors)
-	{
-		ReplacementActor.Key->Destroy();
+		for (TPair<AActor*, AActor*> ReplacementActor : ReplacementActors)
+		{
+			ReplacementActor.Key->Destroy();
+		}
 	}
 
-
 	for (ULevelStreaming* StreamedLevel : StreamedLevels)
 	{
-		if (StreamedLevel->GetCurrentState() == ULevelStreaming::ECurrentState::Removed ||
-			StreamedLevel->GetCurrentState() == ULevelStreaming::ECurrentState::Unloaded ||
-			!IsValid(StreamedLevel)) continue;
 		UnloadFullLevel(StreamedLevel);
 	}
 
 	ReplacementLevels.Empty();
 	ReplacementActors.Empty();
+	Manifest.Reset();
 
-	FEditorDelegates::RefreshLevelBrowser.Broadcast();
+	FLevelBrowserRefresh::Request();
 
 	return FReply::Handled();
 }
@@ -1341,16 +1678,8 @@ FReply FEditorWindowModule::ExecuteScriptButtonClicked()
 			if (CheckAndLog(FilePath.IsEmpty(), "Script file not selected!")) return FReply::Handled();
 			if (CheckAndLog(!FilePath.EndsWith(".py"), "Script is not a python file!")) return FReply::Handled();
 
-			FString Command = "py " + FilePath;
-
-			//execute using the console command executor
-			TArray<IConsoleCommandExecutor*> CommandExecutors = IModularFeatures::Get().GetModularFeatureImplementations<IConsoleCommandExecutor>(IConsoleCommandExecutor::ModularFeatureName());
-			IConsoleCommandExecutor* ActiveCommandExecutor = nullptr;
-
-			ensure(CommandExecutors.IsValidIndex(0));
-
-			ActiveCommandExecutor = CommandExecutors[0];
-			ActiveCommandExecutor->Exec(*Command);
+			//execute in the persistent python scope, modules stay loaded between runs
+			PythonContext.Run(FilePath);
 			break;
 		}
 		case(ExecutionMethod::Blueprint): {
@@ -1365,6 +1694,11 @@ FReply FEditorWindowModule::ExecuteScriptButtonClicked()
 			break;
 		}
 		case(ExecutionMethod::CPP): {
+			if (!NativeGenerator.IsNone()) {
+				RunNativeGenerator();
+				break;
+			}
+
 			if (CheckAndLog(GeneratorClass == nullptr, "No script selected")) break;
 
 			UFunction* Function = GeneratorClass->FindFunctionByName(FName(TEXT("OnGenerateButtonPressed")));
@@ -1377,6 +1711,57 @@ FReply FEditorWindowModule::ExecuteScriptButtonClicked()
 	return FReply::Handled();
 }
 
+FReply FEditorWindowModule::SaveManifestButtonClicked()
+{
+	if (CheckAndLog(Manifest.Levels.Num() == 0 && Manifest.Actors.Num() == 0, "Nothing has been generated yet!")) return FReply::Handled();
+
+	TArray<FString> OutFilenames;
+
+	// open file save dialog
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	const void* Handle = FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr);
+
+	DesktopPlatform->SaveFileDialog(Handle, "Save Generation Manifest", "", "Generation.dgm", "Generation Manifest (*.dgm)|*.dgm", 0, OutFilenames);
+
+	//if the cancel button was pressed
+	if (OutFilenames.Num() == 0)
+	{
+		return FReply::Handled();
+	}
+
+	CheckAndLog(!Manifest.SaveToFile(OutFilenames[0]), "Could not write the manifest file!");
+
+	return FReply::Handled();
+}
+
+FReply FEditorWindowModule::LoadManifestButtonClicked()
+{
+	TArray<FString> OutFilenames;
+
+	// open file selector
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	const void* Handle = FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr);
+
+	DesktopPlatform->OpenFileDialog(Handle, "Select Generation Manifest", "", "", "Generation Manifest (*.dgm)|*.dgm", 0, OutFilenames);
+
+	//if the cancel button was pressed
+	if (OutFilenames.Num() == 0)
+	{
+		return FReply::Handled();
+	}
+
+	FGenerationManifest LoadedManifest;
+	if (CheckAndLog(!LoadedManifest.LoadFromFile(OutFilenames[0]), "File is not a valid generation manifest!")) return FReply::Handled();
+
+	// the current replacement levels are unloaded before the transaction opens, removing a level resets the undo buffer
+	UnloadReplacementLevels(nullptr);
+
+	FGeneratorTransaction Transaction(LOCTEXT("ApplyManifest", "Apply Generation Manifest"), RecordUndo);
+	ApplyManifest(LoadedManifest);
+
+	return FReply::Handled();
+}
+
 
 #undef LOCTEXT_NAMESPACE
 	
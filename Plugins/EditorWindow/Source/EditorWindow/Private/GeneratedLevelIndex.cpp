@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneratedLevelIndex.h"
+#include "Engine/Level.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "LevelUtils.h"
+
+void FGeneratedLevelIndex::Bind()
+{
+	if (LevelAddedHandle.IsValid()) return;
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FGeneratedLevelIndex::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FGeneratedLevelIndex::OnLevelRemoved);
+}
+
+void FGeneratedLevelIndex::Unbind()
+{
+	if (!LevelAddedHandle.IsValid()) return;
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	LevelAddedHandle.Reset();
+	LevelRemovedHandle.Reset();
+}
+
+void FGeneratedLevelIndex::Add(ULevelStreaming* LevelStream)
+{
+	if (LevelStream == nullptr) return;
+
+	Bind();
+	Levels.FindOrAdd(LevelStream);
+
+	// instances are usually loaded later, the level added event fills in the level then
+	if (ULevel* Level = LevelStream->GetLoadedLevel()) TrackLoadedLevel(LevelStream, Level);
+}
+
+void FGeneratedLevelIndex::Remove(ULevelStreaming* LevelStream)
+{
+	if (LevelStream == nullptr) return;
+
+	RemoveStream(LevelStream);
+}
+
+void FGeneratedLevelIndex::RemoveStream(TObjectKey<ULevelStreaming> StreamKey)
+{
+	// only keys are touched, the level may already be garbage collected
+	FTrackedLevel TrackedLevel;
+	if (!Levels.RemoveAndCopyValue(StreamKey, TrackedLevel) || TrackedLevel.Level == TObjectKey<ULevel>()) return;
+
+	StreamOfLevel.Remove(TrackedLevel.Level);
+	StreamsByBuildDataId.Remove(TrackedLevel.BuildDataId, StreamKey);
+}
+
+void FGeneratedLevelIndex::Replace(ULevelStreaming* OldStream, ULevelStreaming* NewStream)
+{
+	if (!Contains(OldStream)) return;
+
+	Remove(OldStream);
+	Add(NewStream);
+}
+
+ULevelStreaming* FGeneratedLevelIndex::FindByBuildDataId(const FGuid& BuildDataId) const
+{
+	for (TMultiMap<FGuid, TObjectKey<ULevelStreaming>>::TConstKeyIterator It = StreamsByBuildDataId.CreateConstKeyIterator(BuildDataId); It; ++It)
+	{
+		if (ULevelStreaming* LevelStream = It.Value().ResolveObjectPtr()) return LevelStream;
+	}
+	return nullptr;
+}
+
+TArray<ULevelStreaming*> FGeneratedLevelIndex::GetLiveLevels() const
+{
+	TArray<ULevelStreaming*> LiveLevels;
+	LiveLevels.Reserve(Levels.Num());
+	for (const TPair<TObjectKey<ULevelStreaming>, FTrackedLevel>& Level : Levels)
+	{
+		ULevelStreaming* LevelStream = Level.Key.ResolveObjectPtr();
+		if (IsLive(LevelStream)) LiveLevels.Add(LevelStream);
+	}
+	return LiveLevels;
+}
+
+void FGeneratedLevelIndex::Empty()
+{
+	Levels.Empty();
+	StreamOfLevel.Empty();
+	StreamsByBuildDataId.Empty();
+}
+
+bool FGeneratedLevelIndex::IsLive(const ULevelStreaming* LevelStream)
+{
+	if (!IsValid(LevelStream)) return false;
+
+	const ULevelStreaming::ECurrentState State = LevelStream->GetCurrentState();
+	return State != ULevelStreaming::ECurrentState::Removed && State != ULevelStreaming::ECurrentState::Unloaded;
+}
+
+void FGeneratedLevelIndex::TrackLoadedLevel(ULevelStreaming* LevelStream, ULevel* Level)
+{
+	FTrackedLevel& TrackedLevel = Levels.FindChecked(LevelStream);
+	if (TrackedLevel.Level == TObjectKey<ULevel>(Level)) return;
+
+	if (TrackedLevel.Level != TObjectKey<ULevel>())
+	{
+		StreamOfLevel.Remove(TrackedLevel.Level);
+		StreamsByBuildDataId.Remove(TrackedLevel.BuildDataId, LevelStream);
+	}
+
+	TrackedLevel.Level = Level;
+	TrackedLevel.BuildDataId = Level->LevelBuildDataId;
+	StreamOfLevel.Add(Level, LevelStream);
+	StreamsByBuildDataId.AddUnique(Level->LevelBuildDataId, LevelStream);
+}
+
+void FGeneratedLevelIndex::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	ULevelStreaming* LevelStream = FLevelUtils::FindStreamingLevel(Level);
+	if (LevelStream && Levels.Contains(LevelStream)) TrackLoadedLevel(LevelStream, Level);
+}
+
+void FGeneratedLevelIndex::OnLevelRemoved(ULevel* Level, UWorld* World)
+{
+	const TObjectKey<ULevelStreaming>* StreamKey = StreamOfLevel.Find(Level);
+	if (StreamKey == nullptr) return;
+
+	// hiding a level removes it from the world too, only drop levels whose stream is gone
+	if (!IsLive(StreamKey->ResolveObjectPtr())) RemoveStream(*StreamKey);
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelBrowserRefresh.h"
+#include "Editor.h"
+#include "WorldBrowser/Public/WorldBrowserModule.h"
+#include "WorldBrowser/Public/LevelFolders.h"
+#include "EditorWindowRuntime.h"
+
+DECLARE_CYCLE_STAT(TEXT("Level Browser Refresh"), STAT_DungeonGen_BrowserRefresh, STATGROUP_DungeonGen);
+
+void FLevelBrowserRefresh::Request()
+{
+	if (TickerHandle.IsValid()) return;
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FLevelBrowserRefresh::Tick));
+}
+
+void FLevelBrowserRefresh::RequestFolderCleanup(FName FolderPath)
+{
+	EmptyFolders.Add(FolderPath);
+	Request();
+}
+
+void FLevelBrowserRefresh::Flush()
+{
+	if (!TickerHandle.IsValid()) return;
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	Tick(0.f);
+}
+
+void FLevelBrowserRefresh::Cancel()
+{
+	if (TickerHandle.IsValid()) FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+	EmptyFolders.Empty();
+}
+
+bool FLevelBrowserRefresh::Tick(float DeltaTime)
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_BrowserRefresh);
+
+	TickerHandle.Reset();
+
+	// delete only the folders that were emptied, instead of rebooting the world browser
+	if (EmptyFolders.Num() > 0 && FLevelFolders::IsAvailable())
+	{
+		FWorldBrowserModule& WBModule = FModuleManager::LoadModuleChecked<FWorldBrowserModule>("WorldBrowser");
+		TSharedPtr<FLevelCollectionModel> WorldModel = WBModule.SharedWorldModel(GEditor->GetEditorWorldContext().World());
+
+		if (WorldModel.IsValid())
+		{
+			for (const FName& FolderPath : EmptyFolders)
+			{
+				FLevelFolders::Get().DeleteFolder(WorldModel, FolderPath);
+			}
+		}
+	}
+	EmptyFolders.Empty();
+
+	FEditorDelegates::RefreshLevelBrowser.Broadcast();
+
+	// one-shot
+	return false;
+}
@@ -4,14 +4,20 @@
 #include "LoadAllStreamingLevels.h"
 #include <EditorLevelUtils.h>
 #include "Engine/LevelStreamingAlwaysLoaded.h"
+#include "PluginManager.h"
 
 bool ULoadAllStreamingLevels::LoadAllStreamingLevels()
 {
-	TArray<ULevelStreaming*> Levels = GEditor->GetEditorWorldContext().World()->GetStreamingLevels();
+	//the streams are replaced in place, walk by index instead of copying the array
+	const TArray<ULevelStreaming*>& Levels = GEditor->GetEditorWorldContext().World()->GetStreamingLevels();
 
-	for (ULevelStreaming* LevelStream : Levels)
+	for (int32 Index = 0; Index < Levels.Num(); Index++)
 	{
-		UEditorLevelUtils::SetStreamingClassForLevel(LevelStream, ULevelStreamingAlwaysLoaded::StaticClass());
+		ULevelStreaming* LevelStream = Levels[Index];
+		if (LevelStream->IsA<ULevelStreamingAlwaysLoaded>()) continue;
+
+		ULevelStreaming* NewLevelStream = UEditorLevelUtils::SetStreamingClassForLevel(LevelStream, ULevelStreamingAlwaysLoaded::StaticClass());
+		PluginManager::GetGeneratedLevels().Replace(LevelStream, NewLevelStream);
 	}
 
 	return true;
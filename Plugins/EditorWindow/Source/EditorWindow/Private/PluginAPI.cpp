@@ -5,6 +5,34 @@
 #include <Kismet/GameplayStatics.h>
 #include "PluginManager.h"
 #include <LevelUtils.h>
+#include "EditorWindow.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spawn Layout"), STAT_DungeonGen_SpawnLayout, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Layout World Load"), STAT_DungeonGen_LayoutWorldLoad, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Update Level Streaming"), STAT_DungeonGen_UpdateLevelStreaming, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Connect Layout"), STAT_DungeonGen_ConnectLayout, STATGROUP_DungeonGen);
+
+//free gateway facing closest to a direction, both in the room's own frame; removed from the lists
+static AGateway* TakeFacingGateway(TArray<AGateway*>& Gateways, TArray<FVector>& Directions, const FVector& Direction)
+{
+	int32 Best = INDEX_NONE;
+	double BestDot = -TNumericLimits<double>::Max();
+	for (int32 Index = 0; Index < Gateways.Num(); Index++)
+	{
+		const double Dot = Directions[Index] | Direction;
+		if (Dot > BestDot)
+		{
+			Best = Index;
+			BestDot = Dot;
+		}
+	}
+	if (Best == INDEX_NONE) return nullptr;
+
+	AGateway* Gateway = Gateways[Best];
+	Gateways.RemoveAtSwap(Best);
+	Directions.RemoveAtSwap(Best);
+	return Gateway;
+}
 
 void UPluginAPI::ShowDialog(FString inputString)
 {
@@ -28,6 +56,126 @@ ULevelStreaming* UPluginAPI::SpawnLevel(FString LevelPath, FVector Position, FRo
 	return LevelsStreamed.Array()[0];
 }
 
+TArray<FSpawnedRoom> UPluginAPI::SpawnLayout(const TArray<FLayoutRoom>& Rooms)
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_SpawnLayout);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<FSpawnedRoom> SpawnedRooms;
+	SpawnedRooms.Reserve(Rooms.Num());
+
+	// layouts reuse the same few rooms, load each world asset once
+	TMap<FString, UWorld*> Worlds;
+
+	for (const FLayoutRoom& Room : Rooms)
+	{
+		UWorld*& World = Worlds.FindOrAdd(Room.LevelPath);
+		if (World == nullptr)
+		{
+			DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_LayoutWorldLoad);
+			World = LoadObject<UWorld>(GetTransientPackage(), *Room.LevelPath);
+		}
+
+		FSpawnedRoom& SpawnedRoom = SpawnedRooms.AddDefaulted_GetRef();
+		if (!ensure(World)) continue;
+
+		FTransform Transform(Room.Rotation, Room.Position, FVector(1,1,1));
+		TSet<ULevelStreaming*> LevelsStreamed = PluginManager::LoadFullLevel(World, Transform, "", FColor::MakeRandomColor());
+
+		SpawnedRoom.Level = LevelsStreamed.Array()[0];
+	}
+
+	//load all the rooms at once
+	{
+		DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_UpdateLevelStreaming);
+		GWorld->UpdateLevelStreaming();
+	}
+
+	for (FSpawnedRoom& SpawnedRoom : SpawnedRooms)
+	{
+		if (SpawnedRoom.Level != nullptr)
+			SpawnedRoom.Gateways = FindGateways(SpawnedRoom.Level);
+	}
+
+	UE_LOG(LogEditorWindow, Log, TEXT("SpawnLayout: %d rooms in %.2f ms"), Rooms.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	return SpawnedRooms;
+}
+
+void UPluginAPI::ConnectLayout(const TArray<FSpawnedRoom>& Rooms, const TArray<TPair<int32, int32>>& Connections)
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_ConnectLayout);
+
+	if (Rooms.Num() == 0) return;
+
+	//the rooms are still where the layout put them, take their transforms and the gateway directions in each room's
+	//own frame before attaching moves any of them
+	TArray<FTransform> LayoutTransforms;
+	TArray<TArray<AGateway*>> FreeGateways;
+	TArray<TArray<FVector>> GatewayDirections;
+	LayoutTransforms.Reserve(Rooms.Num());
+	FreeGateways.Reserve(Rooms.Num());
+	GatewayDirections.Reserve(Rooms.Num());
+	for (const FSpawnedRoom& Room : Rooms)
+	{
+		const FTransform& LayoutTransform = LayoutTransforms.Add_GetRef(Room.Level ? Room.Level->LevelTransform : FTransform::Identity);
+
+		//every gateway connects a single pair of rooms
+		FreeGateways.Add(Room.Gateways);
+		TArray<FVector>& Directions = GatewayDirections.AddDefaulted_GetRef();
+		for (AGateway* Gateway : Room.Gateways)
+		{
+			Directions.Add(LayoutTransform.InverseTransformVectorNoScale(Gateway->GetActorForwardVector()).GetSafeNormal2D());
+		}
+	}
+
+	TBitArray<> Placed(false, Rooms.Num());
+	Placed[0] = true;
+	TArray<AGateway*> UsedGateways;
+
+	//attach the rooms outwards from the first one, each room to the first placed room it's connected to
+	bool bAttachedRoom = true;
+	while (bAttachedRoom)
+	{
+		bAttachedRoom = false;
+		for (const TPair<int32, int32>& Connection : Connections)
+		{
+			int32 From = Connection.Key;
+			int32 To = Connection.Value;
+			if (!Rooms.IsValidIndex(From) || !Rooms.IsValidIndex(To)) continue;
+			if (Placed[To]) Swap(From, To);
+			if (!Placed[From] || Placed[To]) continue;
+
+			ULevelStreaming* Level = Rooms[To].Level;
+			if (Level == nullptr || FreeGateways[From].Num() == 0 || FreeGateways[To].Num() == 0) continue;
+
+			//use the gateways facing each other in the generated layout, the direction to the other room in each room's frame
+			const FVector LayoutDelta = LayoutTransforms[To].GetLocation() - LayoutTransforms[From].GetLocation();
+			AGateway* OutGateway = TakeFacingGateway(FreeGateways[From], GatewayDirections[From], LayoutTransforms[From].InverseTransformVectorNoScale(LayoutDelta).GetSafeNormal2D());
+			AGateway* InGateway = TakeFacingGateway(FreeGateways[To], GatewayDirections[To], LayoutTransforms[To].InverseTransformVectorNoScale(-LayoutDelta).GetSafeNormal2D());
+
+			//AttachLevelToGateway expects the level at the origin
+			FLevelUtils::SetEditorTransform(Level, FTransform::Identity);
+			AttachLevelToGateway(OutGateway, Level, InGateway, false);
+
+			UsedGateways.Add(OutGateway);
+			UsedGateways.Add(InGateway);
+			Placed[To] = true;
+			bAttachedRoom = true;
+		}
+	}
+
+	//delete the used gateways with a single garbage collection
+	if (UsedGateways.Num() == 0) return;
+
+	for (AGateway* Gateway : UsedGateways)
+	{
+		GWorld->EditorDestroyActor(Gateway, true);
+	}
+	PluginManager::ForceGarbageCollection();
+}
+
 void UPluginAPI::ClearAllLevels()
 {
 	PluginManager::ClearAll();
@@ -38,10 +186,17 @@ TArray<AGateway*> UPluginAPI::GetLevelGateways(ULevelStreaming* Level)
 	//load unloaded levels
 	GWorld->UpdateLevelStreaming();
 
+	return FindGateways(Level);
+}
+
+TArray<AGateway*> UPluginAPI::FindGateways(ULevelStreaming* Level)
+{
 	bool bGetOnlyEntryGateways = false;
 
 	TArray<AGateway*> Gateways;
 
+	if (Level->GetLoadedLevel() == nullptr) return Gateways;
+
 	TArray<AActor*> GatewayActors = Level->GetLoadedLevel()->Actors;
 
 	for (AActor* GatewayActor : GatewayActors)
@@ -107,6 +262,6 @@ void UPluginAPI::AttachLevelToGateway(AGateway* OutGateway, ULevelStreaming* Lev
 		GWorld->EditorDestroyActor(OutGateway, true);
 		GWorld->EditorDestroyActor(InGateway, true);
 
-		GEditor->ForceGarbageCollection(true);
+		PluginManager::ForceGarbageCollection();
 	}
 }
\ No newline at end of file
@@ -2,14 +2,32 @@
 
 #include "PluginManager.h"
 #include <Engine/LevelStreamingDynamic.h>
-#include <WorldBrowser/Public/WorldBrowserModule.h>
 #include "EditorLevelUtils.h"
+#include "LevelBrowserRefresh.h"
+#include "EditorWindowRuntime.h"
+
+DECLARE_CYCLE_STAT(TEXT("Load Full Level"), STAT_DungeonGen_LoadFullLevel, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Unload Full Level"), STAT_DungeonGen_UnloadFullLevel, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Remove Sublevel"), STAT_DungeonGen_RemoveSubLevel, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Clear All"), STAT_DungeonGen_ClearAll, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Level Instancing"), STAT_DungeonGen_LevelInstancing, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Garbage Collection"), STAT_DungeonGen_GarbageCollection, STATGROUP_DungeonGen);
 
 UDataTable* PluginManager::GetLevelsDataTable()
 {
 	return LevelsDataTable;
 }
 
+const FGenerationManifest& PluginManager::GetManifest()
+{
+	return Manifest;
+}
+
+FGeneratedLevelIndex& PluginManager::GetGeneratedLevels()
+{
+	return GeneratedLevels;
+}
+
 void PluginManager::GetAllLevels(UWorld* world, TSet<ULevelStreaming*>& OutLevels) {
 	if (world == nullptr) return;
 
@@ -29,6 +47,8 @@ void PluginManager::GetAllLevels(UWorld* world, TSet<ULevelStreaming*>& OutLevel
 
 TSet<ULevelStreaming*> PluginManager::LoadFullLevel(UWorld* World, FTransform Transform, FString FolderName, FLinearColor Color)
 {
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_LoadFullLevel);
+
 	TSet<ULevelStreaming*> AllLevels;
 	TSet<ULevelStreaming*> LoadedLevels;
 
@@ -36,6 +56,8 @@ TSet<ULevelStreaming*> PluginManager::LoadFullLevel(UWorld* World, FTransform Tr
 
 	GetAllLevels(World, AllLevels);
 
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_LevelInstancing);
+
 	ULevelStreaming* RootLevelStream = ULevelStreamingDynamic::LoadLevelInstance(GEditor->GetEditorWorldContext().World(),
 																				World->GetPathName(),
 																				Transform.GetLocation(),
@@ -43,14 +65,15 @@ TSet<ULevelStreaming*> PluginManager::LoadFullLevel(UWorld* World, FTransform Tr
 																				success);
 	ensure(success);
 	LoadedLevels.Add(RootLevelStream);
+	GeneratedLevels.Add(RootLevelStream);
 
 	RootLevelStream->RenameForPIE(PIELevelNameCounter++);
 
-	FEditorDelegates::RefreshLevelBrowser.Broadcast();
-
 	// create a folder if there are sublevels
+	const FName FolderPath("/" + FolderName);
 	if (AllLevels.Num() != 0) {
-		RootLevelStream->SetFolderPath(FName("/" + FolderName));
+		RootLevelStream->SetFolderPath(FolderPath);
+		GeneratedFolders.FindOrAdd(FolderPath)++;
 	}
 
 	RootLevelStream->LevelColor = Color;
@@ -68,78 +91,102 @@ TSet<ULevelStreaming*> PluginManager::LoadFullLevel(UWorld* World, FTransform Tr
 		ensure(success);
 
 		LevelStream->RenameForPIE(PIELevelNameCounter++);
-		LevelStream->SetFolderPath(FName("/" + FolderName));
+		LevelStream->SetFolderPath(FolderPath);
+		GeneratedFolders.FindOrAdd(FolderPath)++;
 		LevelStream->LevelColor = Color;
 
 		LoadedLevels.Add(LevelStream);
+		GeneratedLevels.Add(LevelStream);
 	}
 
 	if (AllLevels.Num() != 0)
 		PIEFolderNameCounter++;
 
-	FEditorDelegates::RefreshLevelBrowser.Broadcast();
+	INC_DWORD_STAT_BY(STAT_DungeonGen_LevelsLoaded, LoadedLevels.Num());
+
+	FLevelBrowserRefresh::Request();
 	return LoadedLevels;
 }
 
 void PluginManager::ClearAll()
 {
-	TArray<ULevelStreaming*> Levels = GEditor->GetEditorWorldContext().World()->GetStreamingLevels();
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_ClearAll);
 
 	ReplacementLevels.Empty();
 	ReplacementActors.Empty();
+	Manifest.Reset();
 
-	for (ULevelStreaming* Level : Levels)
+	//walk backwards, unloading a level removes it from the array
+	const TArray<ULevelStreaming*>& Levels = GEditor->GetEditorWorldContext().World()->GetStreamingLevels();
+	for (int32 Index = Levels.Num() - 1; Index >= 0; Index--)
 	{
-		UnloadFullLevel(Level);
+		if (Levels.IsValidIndex(Index) && FGeneratedLevelIndex::IsLive(Levels[Index])) UnloadFullLevel(Levels[Index]);
 	}
+
+	GeneratedLevels.Empty();
 }
 
 void PluginManager::RemoveSubLevelFromWorld(ULevelStreaming* LevelStream)
 {
-	TArray<ULevelStreaming*> Levels = GEditor->GetEditorWorldContext().World()->GetStreamingLevels();
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_RemoveSubLevel);
 
-	for (ULevelStreaming* LoadedLevel : Levels)
-	{
-		//compare levels by their BuildDataId
-		if (LoadedLevel->GetLoadedLevel()->LevelBuildDataId == LevelStream->GetLoadedLevel()->LevelBuildDataId)
-		{
-			ensure(UEditorLevelUtils::RemoveLevelFromWorld(LoadedLevel->GetLoadedLevel()));
-			FEditorDelegates::RefreshLevelBrowser.Broadcast();
-			break;
-		}
-	}
+	//find the generated level directly or by its BuildDataId
+	ULevelStreaming* LoadedLevel = GeneratedLevels.Contains(LevelStream) ? LevelStream : nullptr;
+	if (LoadedLevel == nullptr && LevelStream->GetLoadedLevel())
+		LoadedLevel = GeneratedLevels.FindByBuildDataId(LevelStream->GetLoadedLevel()->LevelBuildDataId);
+
+	if (LoadedLevel == nullptr || LoadedLevel->GetLoadedLevel() == nullptr) return;
+
+	UnloadFullLevel(LoadedLevel);
 }
 
 void PluginManager::UnloadFullLevel(ULevelStreaming* LevelStream)
 {
-	//FWorldBrowserModule& WBModule = FModuleManager::LoadModuleChecked<FWorldBrowserModule>("WorldBrowser");
-	//TSharedPtr<FLevelCollectionModel> WorldModel = WBModule.SharedWorldModel((UWorld*)LevelStream->GetLoadedLevel()->GetOuter());
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_UnloadFullLevel);
 
 	//remove level stream
+	ReleaseFolder(LevelStream);
+	GeneratedLevels.Remove(LevelStream);
+	//resets the transaction buffer, undo can't restore actors into a level that left the world;
+	//never called inside an open transaction, the passes unload before theirs opens or after it closes
 	ensure(UEditorLevelUtils::RemoveLevelFromWorld(LevelStream->GetLoadedLevel()));
 
-	//cleanup empty folder by rebooting worldbrowser module
-	//WorldModel = nullptr;
-	//WBModule.ShutdownModule();
-	//WBModule.StartupModule();
-
-	//WBModule.OnBrowseWorld.Broadcast(GEditor->GetEditorWorldContext().World());
-
-	FEditorDelegates::RefreshLevelBrowser.Broadcast();
+	FLevelBrowserRefresh::Request();
 }
 
 void PluginManager::CleanupFolders()
 {
-	FWorldBrowserModule& WBModule = FModuleManager::LoadModuleChecked<FWorldBrowserModule>("WorldBrowser");
-	TSharedPtr<FLevelCollectionModel> WorldModel = WBModule.SharedWorldModel(GEditor->GetEditorWorldContext().World());
+	//remove the generator folders that have no levels left and refresh the browser right away
+	for (TMap<FName, int32>::TIterator It = GeneratedFolders.CreateIterator(); It; ++It)
+	{
+		if (It.Value() > 0) continue;
+
+		FLevelBrowserRefresh::RequestFolderCleanup(It.Key());
+		It.RemoveCurrent();
+	}
 
-	//cleanup empty folder by rebooting worldbrowser module
-	WorldModel.Reset();
-	WBModule.ShutdownModule();
-	WBModule.StartupModule();
+	FLevelBrowserRefresh::Request();
+	FLevelBrowserRefresh::Flush();
+}
 
-	WBModule.OnBrowseWorld.Broadcast(GEditor->GetEditorWorldContext().World());
+void PluginManager::ReleaseFolder(ULevelStreaming* LevelStream)
+{
+	const FName FolderPath = LevelStream->GetFolderPath();
+	int32* NumLevels = GeneratedFolders.Find(FolderPath);
+	if (NumLevels == nullptr) return;
 
-	FEditorDelegates::RefreshLevelBrowser.Broadcast();
+	//the folder is removed with the next browser refresh once its last level is gone
+	if (--(*NumLevels) <= 0)
+	{
+		GeneratedFolders.Remove(FolderPath);
+		FLevelBrowserRefresh::RequestFolderCleanup(FolderPath);
+	}
 }
 
+void PluginManager::ForceGarbageCollection()
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_GarbageCollection);
+	INC_DWORD_STAT(STAT_DungeonGen_GCsForced);
+
+	GEditor->ForceGarbageCollection(true);
+}
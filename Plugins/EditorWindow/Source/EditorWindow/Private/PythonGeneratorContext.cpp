@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PythonGeneratorContext.h"
+#include "IPythonScriptPlugin.h"
+#include "HAL/FileManager.h"
+#include "EditorWindow.h"
+
+bool FPythonGeneratorContext::Run(const FString& ScriptPath)
+{
+	IPythonScriptPlugin* Python = IPythonScriptPlugin::Get();
+	if (Python == nullptr || !Python->IsPythonAvailable())
+	{
+		UE_LOG(LogEditorWindow, Error, TEXT("Python is not available, enable the Python Editor Script Plugin."));
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	const FDateTime Timestamp = IFileManager::Get().GetTimeStamp(*ScriptPath);
+	const bool bReload = ScriptPath != LoadedScript || Timestamp != LoadedTimestamp;
+
+	if (bReload)
+	{
+		Reset();
+
+		// drop the entry point of a previous script, the scope is shared between runs
+		Exec(TEXT("globals().pop('generate', None)"), false);
+
+		if (!Exec(ScriptPath, true)) return false;
+
+		FString HasEntryPoint;
+		Exec(TEXT("callable(globals().get('generate'))"), false, &HasEntryPoint);
+		bHasEntryPoint = HasEntryPoint == TEXT("True");
+
+		LoadedScript = ScriptPath;
+		LoadedTimestamp = Timestamp;
+	}
+	else if (!bHasEntryPoint)
+	{
+		// no entry point, the script does its work at module level
+		if (!Exec(ScriptPath, true)) return false;
+	}
+
+	if (bHasEntryPoint && !Exec(TEXT("generate()"), false)) return false;
+
+	UE_LOG(LogEditorWindow, Log, TEXT("Python generator %s in %.2f ms (%s)"),
+		*FPaths::GetCleanFilename(ScriptPath),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0,
+		bReload ? TEXT("loaded") : TEXT("warm"));
+
+	return true;
+}
+
+void FPythonGeneratorContext::Reset()
+{
+	LoadedScript.Reset();
+	LoadedTimestamp = FDateTime();
+	bHasEntryPoint = false;
+}
+
+bool FPythonGeneratorContext::Exec(const FString& Command, bool bExecuteFile, FString* OutResult)
+{
+	FPythonCommandEx PythonCommand;
+	PythonCommand.Command = Command;
+	PythonCommand.ExecutionMode = bExecuteFile ? EPythonCommandExecutionMode::ExecuteFile : EPythonCommandExecutionMode::EvaluateStatement;
+	PythonCommand.FileExecutionScope = EPythonFileExecutionScope::Public;
+
+	const bool bSuccess = IPythonScriptPlugin::Get()->ExecPythonCommandEx(PythonCommand);
+	if (!bSuccess)
+	{
+		UE_LOG(LogEditorWindow, Error, TEXT("Python: %s"), *PythonCommand.CommandResult);
+		Reset();
+	}
+
+	if (OutResult) *OutResult = PythonCommand.CommandResult;
+	return bSuccess;
+}
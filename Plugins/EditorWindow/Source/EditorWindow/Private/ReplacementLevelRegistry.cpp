@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ReplacementLevelRegistry.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "LevelUtils.h"
+
+void FReplacementLevelRegistry::Bind()
+{
+	if (LevelAddedHandle.IsValid()) return;
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FReplacementLevelRegistry::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FReplacementLevelRegistry::OnLevelRemoved);
+}
+
+void FReplacementLevelRegistry::Unbind()
+{
+	if (!LevelAddedHandle.IsValid()) return;
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	LevelAddedHandle.Reset();
+	LevelRemovedHandle.Reset();
+}
+
+void FReplacementLevelRegistry::Add(ULevelStreaming* LayoutLevel, const TSet<ULevelStreaming*>& InReplacements)
+{
+	Bind();
+	RemoveLayout(LayoutLevel);
+
+	Replacements.Add(LayoutLevel, InReplacements);
+	TrackLevel(LayoutLevel);
+
+	for (ULevelStreaming* ReplacementLevel : InReplacements)
+	{
+		Owners.Add(ReplacementLevel, LayoutLevel);
+		TrackLevel(ReplacementLevel);
+	}
+}
+
+TSet<ULevelStreaming*> FReplacementLevelRegistry::RemoveLayout(ULevelStreaming* LayoutLevel)
+{
+	TSet<ULevelStreaming*> Removed;
+	if (!Replacements.RemoveAndCopyValue(LayoutLevel, Removed)) return Removed;
+
+	for (ULevelStreaming* ReplacementLevel : Removed)
+	{
+		Owners.Remove(ReplacementLevel);
+	}
+	return Removed;
+}
+
+void FReplacementLevelRegistry::RemoveReplacement(ULevelStreaming* ReplacementLevel)
+{
+	ULevelStreaming* LayoutLevel = nullptr;
+	if (!Owners.RemoveAndCopyValue(ReplacementLevel, LayoutLevel)) return;
+
+	if (TSet<ULevelStreaming*>* LayoutReplacements = Replacements.Find(LayoutLevel)) LayoutReplacements->Remove(ReplacementLevel);
+}
+
+ULevelStreaming* FReplacementLevelRegistry::FindOwner(ULevelStreaming* ReplacementLevel) const
+{
+	ULevelStreaming* const* LayoutLevel = Owners.Find(ReplacementLevel);
+	return LayoutLevel ? *LayoutLevel : nullptr;
+}
+
+void FReplacementLevelRegistry::Empty()
+{
+	Replacements.Empty();
+	Owners.Empty();
+	StreamOfLevel.Empty();
+	RemovedLevels.Empty();
+}
+
+void FReplacementLevelRegistry::ProcessRemovedLevels(TFunctionRef<void(ULevelStreaming*, const TSet<ULevelStreaming*>&)> OnLayoutRemoved)
+{
+	// the callback may unload levels, which queues more removals; those are handled by the next call
+	TArray<ULevelStreaming*> Removed = MoveTemp(RemovedLevels);
+	RemovedLevels.Reset();
+
+	for (ULevelStreaming* LevelStream : Removed)
+	{
+		// hiding a level removes it from the world too, only levels whose stream is gone count
+		if (IsValid(LevelStream) && LevelStream->GetCurrentState() != ULevelStreaming::ECurrentState::Removed) continue;
+
+		if (Replacements.Contains(LevelStream))
+		{
+			const TSet<ULevelStreaming*> Orphans = RemoveLayout(LevelStream);
+			OnLayoutRemoved(LevelStream, Orphans);
+		}
+		else
+		{
+			RemoveReplacement(LevelStream);
+		}
+	}
+}
+
+void FReplacementLevelRegistry::TrackLevel(ULevelStreaming* LevelStream)
+{
+	if (LevelStream && LevelStream->GetLoadedLevel()) StreamOfLevel.Add(LevelStream->GetLoadedLevel(), LevelStream);
+}
+
+void FReplacementLevelRegistry::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	// replacement levels are usually loaded after they got registered
+	ULevelStreaming* LevelStream = FLevelUtils::FindStreamingLevel(Level);
+	if (LevelStream && (Owners.Contains(LevelStream) || Replacements.Contains(LevelStream))) StreamOfLevel.Add(Level, LevelStream);
+}
+
+void FReplacementLevelRegistry::OnLevelRemoved(ULevel* Level, UWorld* World)
+{
+	ULevelStreaming* LevelStream = nullptr;
+	if (!StreamOfLevel.RemoveAndCopyValue(Level, LevelStream)) return;
+
+	// levels unregistered by the generator itself don't need reconciling
+	if (Owners.Contains(LevelStream) || Replacements.Contains(LevelStream)) RemovedLevels.Add(LevelStream);
+}
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DungeonGenBenchmark.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// DungeonGen.Benchmark.<Rows>x<Actors>, headless with
+//   UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests DungeonGen.Benchmark; Quit"
+//                    [-DungeonGenBaseline=<csv>] [-DungeonGenTolerance=1.5]
+// every scale writes its csv to Saved/Profiling/DungeonGen and fails on a pass that regressed against the baseline
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FDungeonGenBenchmarkTest, "DungeonGen.Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FDungeonGenBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const FIntPoint Scales[] = { { 10, 100 }, { 100, 1000 }, { 1000, 10000 }, { 10000, 100000 } };
+	for (const FIntPoint& Scale : Scales)
+	{
+		const FString Name = FString::Printf(TEXT("%dx%d"), Scale.X, Scale.Y);
+		OutBeautifiedNames.Add(Name);
+		OutTestCommands.Add(Name);
+	}
+}
+
+bool FDungeonGenBenchmarkTest::RunTest(const FString& Parameters)
+{
+	FString Rows;
+	FString Actors;
+	if (!TestTrue(TEXT("Scale is <Rows>x<Actors>"), Parameters.Split(TEXT("x"), &Rows, &Actors))) return false;
+
+	FDungeonGenBenchmark Benchmark;
+	Benchmark.RunScale(FCString::Atoi(*Rows), FCString::Atoi(*Actors));
+	TestFalse(TEXT("All passes ran on the synthetic data"), Benchmark.bFailed);
+
+	for (const FDungeonGenBenchmarkResult& Result : Benchmark.Results)
+	{
+		AddInfo(FString::Printf(TEXT("%s: %.2f ms, %.1f MB (peak %.1f MB)"), *Result.Pass, Result.Milliseconds, Result.UsedMB, Result.PeakMB));
+	}
+
+	const FString OutputPath = FDungeonGenBenchmark::GetDefaultOutputPath();
+	TestTrue(TEXT("Results are written"), FFileHelper::SaveStringToFile(Benchmark.ToCsv(), *OutputPath));
+
+	FString BaselinePath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("DungeonGenBaseline="), BaselinePath))
+	{
+		float Tolerance = 1.5f;
+		FParse::Value(FCommandLine::Get(), TEXT("DungeonGenTolerance="), Tolerance);
+		TestEqual(TEXT("Passes slower than the baseline"), Benchmark.CompareWithBaseline(BaselinePath, Tolerance), 0);
+	}
+
+	return true;
+}
+
+#endif
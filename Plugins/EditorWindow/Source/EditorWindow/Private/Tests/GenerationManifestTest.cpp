@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GenerationManifest.h"
+#include "GeneratorSelection.h"
+#include "GeneratorTypes.h"
+#include "Engine/DataTable.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static FGenerationManifest MakeTestManifest()
+{
+	FGenerationManifest Manifest;
+	Manifest.LevelsSeed = 1234;
+	Manifest.TagsSeed = 42;
+	Manifest.ActorsSeed = 7;
+	Manifest.LevelsDataTableHash = 0x12345678;
+	Manifest.TagsDataTableHash = 0x9ABCDEF0;
+	Manifest.ActorsDataTableHash = 0x0F1E2D3C;
+
+	FManifestLevelEntry Level;
+	Level.LayoutLevel = { FName(TEXT("/Game/Layout/Room_A")), 1 };
+	Level.ReplaceWorldPath = TEXT("/Game/Rooms/Room_B.Room_B");
+	Level.FolderName = TEXT("Generated");
+	Level.Transform = FTransform(FRotator(0.0, 90.0, 0.0), FVector(100.0, 200.0, 300.0));
+	Level.Color = FLinearColor(0.25f, 0.5f, 0.75f);
+	Manifest.SetLevel(Level);
+
+	FManifestActorEntry Actor;
+	Actor.Level = Level.LayoutLevel;
+	Actor.SourceActorName = TEXT("Spawn_3");
+	Actor.ReplaceActorClassPath = TEXT("/Script/Engine.Actor");
+	Actor.Transform = FTransform(FVector(10.0, 20.0, 30.0));
+	Manifest.SetActor(Actor);
+
+	return Manifest;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerationManifestRoundTripTest, "DungeonGen.Manifest.RoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGenerationManifestRoundTripTest::RunTest(const FString& Parameters)
+{
+	FGenerationManifest Manifest = MakeTestManifest();
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes, true);
+	Writer << Manifest;
+
+	FGenerationManifest Loaded;
+	FMemoryReader Reader(Bytes, true);
+	Reader << Loaded;
+	if (!TestFalse(TEXT("Manifest reads back without error"), Reader.IsError())) return false;
+
+	TestEqual(TEXT("Levels seed"), Loaded.LevelsSeed, Manifest.LevelsSeed);
+	TestEqual(TEXT("Tags seed"), Loaded.TagsSeed, Manifest.TagsSeed);
+	TestEqual(TEXT("Actors seed"), Loaded.ActorsSeed, Manifest.ActorsSeed);
+	TestEqual(TEXT("Levels datatable hash"), Loaded.LevelsDataTableHash, Manifest.LevelsDataTableHash);
+	TestEqual(TEXT("Tags datatable hash"), Loaded.TagsDataTableHash, Manifest.TagsDataTableHash);
+	TestEqual(TEXT("Actors datatable hash"), Loaded.ActorsDataTableHash, Manifest.ActorsDataTableHash);
+
+	if (TestEqual(TEXT("Level entries"), Loaded.Levels.Num(), 1))
+	{
+		const FManifestLevelEntry& Level = Loaded.Levels[0];
+		TestTrue(TEXT("Layout level"), Level.LayoutLevel == Manifest.Levels[0].LayoutLevel);
+		TestEqual(TEXT("Replace world"), Level.ReplaceWorldPath, Manifest.Levels[0].ReplaceWorldPath);
+		TestEqual(TEXT("Folder"), Level.FolderName, Manifest.Levels[0].FolderName);
+		TestTrue(TEXT("Level transform"), Level.Transform.Equals(Manifest.Levels[0].Transform));
+		TestEqual(TEXT("Level color"), Level.Color, Manifest.Levels[0].Color);
+	}
+
+	if (TestEqual(TEXT("Actor entries"), Loaded.Actors.Num(), 1))
+	{
+		const FManifestActorEntry& Actor = Loaded.Actors[0];
+		TestTrue(TEXT("Actor level"), Actor.Level == Manifest.Actors[0].Level);
+		TestEqual(TEXT("Source actor"), Actor.SourceActorName, Manifest.Actors[0].SourceActorName);
+		TestEqual(TEXT("Replace class"), Actor.ReplaceActorClassPath, Manifest.Actors[0].ReplaceActorClassPath);
+		TestTrue(TEXT("Actor transform"), Actor.Transform.Equals(Manifest.Actors[0].Transform));
+	}
+
+	// writing the loaded manifest again has to give the same bytes, the encoding has no run dependent state
+	TArray<uint8> RewrittenBytes;
+	FMemoryWriter Rewriter(RewrittenBytes, true);
+	Rewriter << Loaded;
+	TestTrue(TEXT("Re-serialized manifest is byte identical"), RewrittenBytes == Bytes);
+
+	// a file that isn't a manifest is rejected
+	Bytes[0] ^= 0xFF;
+	FGenerationManifest Corrupt;
+	FMemoryReader CorruptReader(Bytes, true);
+	CorruptReader << Corrupt;
+	TestTrue(TEXT("Wrong magic number is an error"), CorruptReader.IsError());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerationManifestDataTableHashTest, "DungeonGen.Manifest.DataTableHash",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGenerationManifestDataTableHashTest::RunTest(const FString& Parameters)
+{
+	FTagsStruct First;
+	First.ActorTag = TEXT("Spawn");
+	First.NumberOfElements = 3;
+	First.ReplaceActor = AActor::StaticClass();
+
+	FTagsStruct Second;
+	Second.ActorTag = TEXT("Chest");
+	Second.NumberOfElements = 1;
+	Second.ReplaceActor = AActor::StaticClass();
+
+	// the same rows added in a different order
+	UDataTable* DataTable = NewObject<UDataTable>(GetTransientPackage());
+	DataTable->RowStruct = FTagsStruct::StaticStruct();
+	DataTable->AddRow(TEXT("Row_1"), First);
+	DataTable->AddRow(TEXT("Row_2"), Second);
+
+	UDataTable* ReorderedDataTable = NewObject<UDataTable>(GetTransientPackage());
+	ReorderedDataTable->RowStruct = FTagsStruct::StaticStruct();
+	ReorderedDataTable->AddRow(TEXT("Row_2"), Second);
+	ReorderedDataTable->AddRow(TEXT("Row_1"), First);
+
+	const uint32 Hash = FGenerationManifest::HashDataTable(DataTable);
+	TestEqual(TEXT("Hash doesn't depend on the row order"), FGenerationManifest::HashDataTable(ReorderedDataTable), Hash);
+	TestEqual(TEXT("Hash is the same on every call"), FGenerationManifest::HashDataTable(DataTable), Hash);
+
+	Second.NumberOfElements = 2;
+	ReorderedDataTable->AddRow(TEXT("Row_2"), Second);
+	TestNotEqual(TEXT("Hash changes with the row content"), FGenerationManifest::HashDataTable(ReorderedDataTable), Hash);
+
+	TestEqual(TEXT("Missing datatable hashes to 0"), FGenerationManifest::HashDataTable(nullptr), 0u);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerationManifestSelectionStreamsTest, "DungeonGen.Manifest.SelectionStreams",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGenerationManifestSelectionStreamsTest::RunTest(const FString& Parameters)
+{
+	const FManifestLevelRef LevelRef = { FName(TEXT("/Game/Layout/Room_A")), 0 };
+	const FManifestLevelRef OtherLevelRef = { FName(TEXT("/Game/Layout/Room_A")), 1 };
+
+	// a level's stream only depends on the seed and its reference
+	FRandomStream Stream = GeneratorSelection::MakeLevelRandomStream(1234, LevelRef);
+	FRandomStream SameStream = GeneratorSelection::MakeLevelRandomStream(1234, LevelRef);
+	FRandomStream OtherStream = GeneratorSelection::MakeLevelRandomStream(1234, OtherLevelRef);
+
+	bool bSameSequence = true;
+	bool bOtherSequenceDiffers = false;
+	for (int32 Index = 0; Index < 16; Index++)
+	{
+		const int32 Value = Stream.RandRange(0, 1000000);
+		bSameSequence &= Value == SameStream.RandRange(0, 1000000);
+		bOtherSequenceDiffers |= Value != OtherStream.RandRange(0, 1000000);
+	}
+	TestTrue(TEXT("Same seed and level give the same sequence"), bSameSequence);
+	TestTrue(TEXT("Another occurrence of the level gets its own sequence"), bOtherSequenceDiffers);
+
+	// weighted entries hash their asset path, never an object address, so set order is the same in every session
+	FWeightedActor WeightedActor;
+	WeightedActor.Actor = AActor::StaticClass();
+	WeightedActor.Weight = 3;
+	const uint32 ExpectedHash = HashCombine(GetTypeHash(FSoftObjectPath(TEXT("/Script/Engine.Actor"))), GetTypeHash(uint16(3)));
+	TestEqual(TEXT("Weighted actor hash is path based"), GetTypeHash(WeightedActor), ExpectedHash);
+
+	return true;
+}
+
+#endif
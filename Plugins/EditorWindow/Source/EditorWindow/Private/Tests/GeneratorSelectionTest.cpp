@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneratorSelection.h"
+#include "GeneratorTypes.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static TArray<int32> MakeSequence(int32 Num)
+{
+	TArray<int32> Elements;
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		Elements.Add(Index);
+	}
+	return Elements;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGeneratorSelectRandomSubsetTest, "DungeonGen.Selection.SelectRandomSubset",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGeneratorSelectRandomSubsetTest::RunTest(const FString& Parameters)
+{
+	// the selection of a seed is part of the saved manifests, it must never change
+	{
+		TArray<int32> Elements = MakeSequence(10);
+		FRandomStream RandomStream(42);
+		const int32 NumSelected = GeneratorSelection::SelectRandomSubset(Elements, 4, RandomStream);
+		TestEqual(TEXT("Selected count"), NumSelected, 4);
+		TestTrue(TEXT("4 of 10 with seed 42"), TArray<int32>(Elements.GetData(), 4) == TArray<int32>({ 1, 2, 6, 7 }));
+	}
+	{
+		TArray<int32> Elements = MakeSequence(100);
+		FRandomStream RandomStream(1234);
+		GeneratorSelection::SelectRandomSubset(Elements, 5, RandomStream);
+		TestTrue(TEXT("5 of 100 with seed 1234"), TArray<int32>(Elements.GetData(), 5) == TArray<int32>({ 61, 17, 8, 73, 95 }));
+	}
+
+	// the same seed gives the same selection, and the array stays a permutation of its elements
+	TArray<int32> First = MakeSequence(1000);
+	TArray<int32> Second = MakeSequence(1000);
+	FRandomStream FirstStream(7);
+	FRandomStream SecondStream(7);
+	GeneratorSelection::SelectRandomSubset(First, 50, FirstStream);
+	GeneratorSelection::SelectRandomSubset(Second, 50, SecondStream);
+	TestTrue(TEXT("Same seed, same selection"), First == Second);
+
+	TArray<int32> Sorted = First;
+	Sorted.Sort();
+	TestTrue(TEXT("Selection is a permutation"), Sorted == MakeSequence(1000));
+
+	// more than there are elements selects all of them, nothing selects nothing
+	TArray<int32> Small = MakeSequence(3);
+	FRandomStream SmallStream(1);
+	TestEqual(TEXT("Clamped to the element count"), GeneratorSelection::SelectRandomSubset(Small, 300, SmallStream), 3);
+	TestEqual(TEXT("Negative selects nothing"), GeneratorSelection::SelectRandomSubset(Small, -1, SmallStream), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGeneratorWeightedRandomTest, "DungeonGen.Selection.WeightedRandom",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGeneratorWeightedRandomTest::RunTest(const FString& Parameters)
+{
+	// a set keeps the insertion order as long as nothing is removed
+	const TArray<UClass*> Classes = { AActor::StaticClass(), APawn::StaticClass(), ACharacter::StaticClass(), AInfo::StaticClass() };
+	const uint16 Weights[] = { 1, 0, 3, 6 };
+
+	TSet<FWeightedActor> WeightedActors;
+	for (int32 Index = 0; Index < Classes.Num(); Index++)
+	{
+		FWeightedActor WeightedActor;
+		WeightedActor.Actor = Classes[Index];
+		WeightedActor.Weight = Weights[Index];
+		WeightedActors.Add(WeightedActor);
+	}
+	const int32 SumOfWeights = GeneratorSelection::SumOfWeights(WeightedActors);
+	TestEqual(TEXT("Sum of weights"), SumOfWeights, 10);
+
+	auto Pick = [&](int32 Seed, int32 Count)
+	{
+		TArray<int32> Picks;
+		FRandomStream RandomStream(Seed);
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			const FWeightedActor* Picked = GeneratorSelection::WeightedRandom(WeightedActors, RandomStream, SumOfWeights);
+			Picks.Add(Picked ? Classes.IndexOfByKey(Picked->Actor.Get()) : INDEX_NONE);
+		}
+		return Picks;
+	};
+
+	TestTrue(TEXT("8 picks with seed 7"), Pick(7, 8) == TArray<int32>({ 3, 3, 3, 2, 2, 2, 3, 2 }));
+	TestTrue(TEXT("Same seed, same picks"), Pick(99, 100) == Pick(99, 100));
+	TestFalse(TEXT("Zero weight is never picked"), Pick(99, 1000).Contains(1));
+
+	FRandomStream RandomStream(1);
+	TestNull(TEXT("No pick without weights"), GeneratorSelection::WeightedRandom(WeightedActors, RandomStream, 0));
+
+	return true;
+}
+
+#endif
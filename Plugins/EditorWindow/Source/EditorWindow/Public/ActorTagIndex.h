@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class ULevel;
+struct FPropertyChangedEvent;
+
+// Index of the editor world's actors by tag, grouped per level. Built in a single pass over the world and kept
+// up to date through the actor added/deleted delegates, so the generator passes don't scan every actor per row.
+class EDITORWINDOW_API FActorTagIndex
+{
+public:
+	FActorTagIndex() = default;
+	~FActorTagIndex();
+	UE_NONCOPYABLE(FActorTagIndex);
+
+	// unbind from the engine delegates
+	void Shutdown();
+
+	// the next query rebuilds the index
+	void MarkDirty();
+
+	// actors with the tag grouped per level, in world iteration order; nullptr if no actor has the tag. points into
+	// the index, so it's only valid until actors are spawned or destroyed in the world
+	const TMap<ULevel*, TArray<AActor*>>* FindActorsByLevel(UWorld* World, FName Tag);
+
+	// all actors with the tag
+	TArray<AActor*> GetActors(UWorld* World, FName Tag);
+
+	// stop incremental updates while a batch of actors is spawned, the batch is indexed in one go on resume
+	// (after the construction scripts ran, which may still change the tags)
+	void SuspendUpdates();
+	void ResumeUpdates(TConstArrayView<AActor*> SpawnedActors);
+
+private:
+	void Bind();
+	void Rebuild(UWorld* World);
+
+	void AddActor(AActor* Actor);
+	void OnActorAdded(AActor* Actor);
+	void OnActorDeleted(AActor* Actor);
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+	void OnLevelChanged(ULevel* Level, UWorld* World);
+
+	TMap<FName, TMap<ULevel*, TArray<AActor*>>> ActorsByTag;
+	TWeakObjectPtr<UWorld> IndexedWorld;
+	bool bDirty = true;
+	bool bBound = false;
+	int32 SuspendCount = 0;
+
+	FDelegateHandle ActorAddedHandle;
+	FDelegateHandle ActorDeletedHandle;
+	FDelegateHandle PropertyChangedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
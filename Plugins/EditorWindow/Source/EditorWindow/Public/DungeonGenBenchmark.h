@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDataTable;
+
+struct FDungeonGenBenchmarkResult
+{
+	FString Pass;
+	int32 Rows = 0;
+	int32 Actors = 0;
+	double Milliseconds = 0.0;
+	double UsedMB = 0.0;
+	double PeakMB = 0.0;
+
+	FString GetKey() const { return FString::Printf(TEXT("%s|%d|%d"), *Pass, Rows, Actors); }
+};
+
+// Runs the generator passes of FEditorWindowModule on synthetic datatables and room worlds in the editor world, used
+// by the benchmark commandlet and the DungeonGen.Benchmark automation tests. The room worlds are saved once to
+// Intermediate/DungeonGenBenchmark and reused by later runs; everything a scale generates is removed again.
+class EDITORWINDOW_API FDungeonGenBenchmark
+{
+public:
+	// run all passes with NumRows rows in every datatable and NumActors actors in the world
+	void RunScale(int32 NumRows, int32 NumActors);
+
+	FString ToCsv() const;
+
+	// compare with the timings of a previous run, returns the number of regressed passes
+	int32 CompareWithBaseline(const FString& BaselinePath, double Tolerance) const;
+
+	// default csv file in Saved/Profiling/DungeonGen
+	static FString GetDefaultOutputPath();
+
+	TArray<FDungeonGenBenchmarkResult> Results;
+
+	// a pass couldn't run on the synthetic data
+	bool bFailed = false;
+
+private:
+	template<typename FunctionType>
+	void Measure(const FString& Pass, int32 NumRows, int32 NumActors, FunctionType&& Function);
+
+	// save the room worlds that aren't on disk yet
+	void MakeRoomWorlds(int32 NumRooms);
+
+	static UDataTable* MakeLevelsTable(int32 NumRows);
+	static UDataTable* MakeTagsTable(int32 NumRows, int32 NumActors);
+	static UDataTable* MakeActorsTable();
+};
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DungeonGenBenchmarkCommandlet.generated.h"
+
+// Benchmarks the generator passes on synthetic datatables and worlds, headless:
+//   UnrealEditor-Cmd <Project> -run=DungeonGenBenchmark -nullrhi [-Rows=10,100,1000,10000] [-Actors=100,1000,10000,100000]
+//                    [-Output=<csv>] [-Baseline=<csv>] [-Tolerance=1.5]
+// Rows and Actors are paired by index, one scale per pair. Timings and memory are written as csv to
+// Saved/Profiling/DungeonGen; with a baseline csv the commandlet fails if a pass got slower than Tolerance times the baseline.
+// The same scales run as the DungeonGen.Benchmark automation tests, see FDungeonGenBenchmark.
+UCLASS()
+class UDungeonGenBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UDungeonGenBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -7,85 +7,16 @@
 #include <UObject/ObjectMacros.h>
 #include "PluginManager.h"
 #include "GeneratorActor.h"
-#include "EditorWindow.generated.h"
+#include "GeneratorTypes.h"
+#include "GenerationManifest.h"
+#include "LevelIdentityCache.h"
+#include "ActorTagIndex.h"
+#include "BulkActorSpawner.h"
+#include "PythonGeneratorContext.h"
+#include "DungeonGenerator.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogEditorWindow, Log, All);
 
-// Helper structs (TPair cant work on UPROPERTY)
-USTRUCT(BlueprintType)
-struct FWeightedWorld
-{
-	GENERATED_BODY()
-
-	UPROPERTY(EditAnywhere)
-	TSoftObjectPtr<UWorld> World;
-
-	UPROPERTY(EditAnywhere)
-	uint16 Weight;
-};
-
-USTRUCT(BlueprintType)
-struct FWeightedActor
-{
-	GENERATED_BODY()
-
-	UPROPERTY(EditAnywhere)
-	TSubclassOf<AActor> Actor;
-
-	UPROPERTY(EditAnywhere)
-	uint16 Weight;
-};
-
-// hash function for the helper stucts, used when they get put in a set
-inline uint32 GetTypeHash(const FWeightedWorld& World)
-{
-	return FCrc::MemCrc32(&World, sizeof(FWeightedWorld));
-}
-
-inline uint32 GetTypeHash(const FWeightedActor& Actor)
-{
-	return FCrc::MemCrc32(&Actor, sizeof(FWeightedActor));
-}
-
-
-// Structs to use for the levels datatables
-USTRUCT(BlueprintType)
-struct FLevelsStruct : public FTableRowBase
-{
-	GENERATED_BODY()
-
-	UPROPERTY(EditAnywhere)
-	TSoftObjectPtr<UWorld> World;
-
-	UPROPERTY(EditAnywhere)
-	TSet<FWeightedWorld> ReplaceWorlds;
-};
-
-USTRUCT(BlueprintType)
-struct FTagsStruct : public FTableRowBase
-{
-	GENERATED_BODY()
-
-	UPROPERTY(EditAnywhere)
-	FName ActorTag;
-
-	UPROPERTY(EditAnywhere)
-	uint8 NumberOfElements;
-
-	UPROPERTY(EditAnywhere)
-	TSubclassOf<AActor> ReplaceActor;
-};
-
-USTRUCT(BlueprintType)
-struct FActorsStruct : public FTableRowBase
-{
-	GENERATED_BODY()
-
-	UPROPERTY(EditAnywhere)
-	TSubclassOf<AActor> Actor;
-
-	UPROPERTY(EditAnywhere)
-	TSet<FWeightedActor> ReplaceActors;
-};
 
 // enum for generation algorithm execution method
 #undef CPP
@@ -117,6 +48,12 @@ public:
 	
 	/** This function will be bound to Command (by default it will bring up plugin window) */
 	void PluginButtonClicked();
+
+	// the generator passes on the editor world, without seed randomization or undo transaction; called by the
+	// buttons and by the benchmarks
+	void GenerateLevels(UDataTable* InLevelsDataTable, int32 Seed);
+	void GenerateTags(UDataTable* InTagsDataTable, int32 Seed);
+	void GenerateActors(UDataTable* InActorsDataTable, int32 Seed);
 	
 private:
 
@@ -128,6 +65,8 @@ private:
 	FReply MergeButtonClicked();
 	FReply OpenFileButtonClicked();
 	FReply ExecuteScriptButtonClicked();
+	FReply SaveManifestButtonClicked();
+	FReply LoadManifestButtonClicked();
 
 	TSharedRef<class SDockTab> OnSpawnPluginTab(const class FSpawnTabArgs& SpawnTabArgs);
 
@@ -167,14 +106,28 @@ private:
 	// path to the selected python script
 	FString FilePath;
 
+	// keeps the selected python generator loaded between runs
+	FPythonGeneratorContext PythonContext;
+
+	// native generators of the C++ execution method, NAME_None runs the selected script class instead
+	TArray<TSharedPtr<FName>> NativeGeneratorItems;
+	TSharedPtr<STextBlock> NativeGeneratorTitleBlock;
+	FName NativeGenerator;
+
+	// record each generator pass as one undo step, disabled for huge runs to keep the undo buffer small
+	bool RecordUndo = true;
+
 	// stop the invoking of RefreshLevelBrowser logic when levels are deleted within
 	bool CurrentlyDeleting = false;
 
 	// check the Value expression and log a message if it's false; returns the Value
 	bool CheckAndLog(bool Value, FString MessageToLog);
 
-	// clear all engine formatting of a level path
-	FString ClearPathFormatting(FString InputString);
+	// package keys of the levels datatable rows and the streamed levels
+	FLevelIdentityCache LevelIdentities;
+
+	// editor world actors by tag, queried by the tags pass and merge
+	FActorTagIndex TagIndex;
 
 
 	// binded to FEditorDelegates::OnAddLevelToWorld event, invoked after a level is added through the levels menu
@@ -194,4 +147,26 @@ private:
 
 	// return random actor from a list of weighted actors using a given random stream
 	UClass* WeightedRandomActor(TSet<FWeightedActor> WeightedActors, FRandomStream& RandomStream, uint16 SumOfWeights);
+
+	// cache of manifest references for the levels touched by the current generation pass
+	TMap<ULevel*, FManifestLevelRef> LevelRefs;
+
+	// build the manifest reference of the level an actor lives in
+	FManifestLevelRef MakeLevelRef(ULevel* Level);
+
+	// spawn a batch of replacement actors for the given source actors and store them
+	void SpawnReplacementActors(const TArray<AActor*>& SourceActors, const TArray<FActorSpawnRequest>& SpawnRequests);
+
+	// store a spawned replacement actor and record it in the manifest
+	void AddReplacementActor(AActor* SourceActor, AActor* ReplacementActor, UClass* ReplaceActorClass);
+
+	// unload the replacement levels of the layout levels that have a row in InLevelsDataTable, of all layout levels
+	// without a datatable; removing a level resets the undo buffer, so the buttons call this before their transaction
+	void UnloadReplacementLevels(UDataTable* InLevelsDataTable);
+
+	// re-create the levels and actors recorded in a manifest without running the selection
+	void ApplyManifest(const FGenerationManifest& InManifest);
+
+	// run the selected native generator and spawn its layout
+	void RunNativeGenerator();
 };
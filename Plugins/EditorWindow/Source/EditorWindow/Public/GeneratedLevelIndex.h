@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class ULevel;
+class ULevelStreaming;
+
+// Streaming levels spawned by the generator, indexed by stream and by the LevelBuildDataId of their loaded level.
+// Kept up to date from the level added/removed events, so the generator only visits its own levels and finding
+// one by build data id doesn't scan the world's streaming levels. Levels and streams are held by key and weak
+// pointer, entries whose objects got garbage collected are never dereferenced.
+class EDITORWINDOW_API FGeneratedLevelIndex
+{
+public:
+	FGeneratedLevelIndex() = default;
+	UE_NONCOPYABLE(FGeneratedLevelIndex);
+
+	void Add(ULevelStreaming* LevelStream);
+	void Remove(ULevelStreaming* LevelStream);
+
+	// the stream of a generated level got recreated (e.g. its streaming class changed)
+	void Replace(ULevelStreaming* OldStream, ULevelStreaming* NewStream);
+
+	bool Contains(const ULevelStreaming* LevelStream) const { return Levels.Contains(LevelStream); }
+
+	// generated level whose loaded level has the build data id, nullptr if there's none
+	ULevelStreaming* FindByBuildDataId(const FGuid& BuildDataId) const;
+
+	// generated levels that are still loaded (not unloaded or removed)
+	TArray<ULevelStreaming*> GetLiveLevels() const;
+
+	int32 Num() const { return Levels.Num(); }
+
+	void Empty();
+
+	// stop listening to the level events, called when the module shuts down; the index is a static and its
+	// destructor runs after the world delegates may already be gone
+	void Unbind();
+
+	// streaming state check shared by all level iterations of the generator
+	static bool IsLive(const ULevelStreaming* LevelStream);
+
+private:
+	void Bind();
+	void TrackLoadedLevel(ULevelStreaming* LevelStream, ULevel* Level);
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+	void OnLevelRemoved(ULevel* Level, UWorld* World);
+
+	// loaded level of a generated stream, with its build data id so the entry can be removed after the level is gone
+	struct FTrackedLevel
+	{
+		TObjectKey<ULevel> Level;
+		FGuid BuildDataId;
+	};
+
+	void RemoveStream(TObjectKey<ULevelStreaming> StreamKey);
+
+	// every generated stream and its loaded level, a null key while it isn't loaded
+	TMap<TObjectKey<ULevelStreaming>, FTrackedLevel> Levels;
+	TMap<TObjectKey<ULevel>, TObjectKey<ULevelStreaming>> StreamOfLevel;
+	TMultiMap<FGuid, TObjectKey<ULevelStreaming>> StreamsByBuildDataId;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
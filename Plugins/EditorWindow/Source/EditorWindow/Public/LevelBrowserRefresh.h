@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+// Coalesces level browser refreshes: any number of requests within a frame result in a single
+// FEditorDelegates::RefreshLevelBrowser broadcast on the next editor tick.
+class EDITORWINDOW_API FLevelBrowserRefresh
+{
+public:
+	// mark the level browser dirty
+	static void Request();
+
+	// remove a generator folder that has no levels left, done together with the next refresh
+	static void RequestFolderCleanup(FName FolderPath);
+
+	// refresh right away if a refresh is pending
+	static void Flush();
+
+	// drop a pending refresh, used when the editor world changes
+	static void Cancel();
+
+private:
+	static bool Tick(float DeltaTime);
+
+	static inline FTSTicker::FDelegateHandle TickerHandle;
+	static inline TSet<FName> EmptyFolders;
+};
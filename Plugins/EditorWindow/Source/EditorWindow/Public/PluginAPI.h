@@ -5,15 +5,37 @@
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Engine/LevelStreaming.h"
+#include "Gateway.h"
 #include "PluginAPI.generated.h"
 
-UCLASS(Blueprintable)
-class EDITORWINDOW_API AGateway : public AActor
+// one room of a layout submitted through SpawnLayout
+USTRUCT(BlueprintType)
+struct FLayoutRoom
 {
 	GENERATED_BODY()
-public:
-	UPROPERTY(EditAnywhere)
-	bool EntryGateway;
+
+	// world asset path of the room
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PluginAPI")
+	FString LevelPath;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PluginAPI")
+	FVector Position = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PluginAPI")
+	FRotator Rotation = FRotator::ZeroRotator;
+};
+
+// spawned room of a layout, in the order of the submitted rooms
+USTRUCT(BlueprintType)
+struct FSpawnedRoom
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="PluginAPI")
+	ULevelStreaming* Level = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category="PluginAPI")
+	TArray<AGateway*> Gateways;
 };
 
 UCLASS()
@@ -35,6 +57,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category="PluginAPI")
 	static ULevelStreaming* SpawnLevel(FString LevelPath, FVector Position, FRotator Rotation);
 
+	// spawn a whole layout at once: streaming is updated a single time for all rooms,
+	// returns the spawned level and gateways of every room
+	UFUNCTION(BlueprintCallable, Category="PluginAPI")
+	static TArray<FSpawnedRoom> SpawnLayout(const TArray<FLayoutRoom>& Rooms);
+
+	// attach the rooms of a spawned layout to each other through their gateways, connections are pairs of room
+	// indices; the rooms have to be where SpawnLayout put them, the gateways of a connection are the ones facing the
+	// other room in the layout. the first room stays in place, connections that close a loop are skipped
+	static void ConnectLayout(const TArray<FSpawnedRoom>& Rooms, const TArray<TPair<int32, int32>>& Connections);
+
 	// delete all streamed levels from the editor world
 	UFUNCTION(BlueprintCallable, Category="PluginAPI")
 	static void ClearAllLevels();
@@ -46,4 +78,8 @@ public:
 	// connect the given level to a gateway
 	UFUNCTION(BlueprintCallable, Category = "PluginAPI")
 	static void AttachLevelToGateway(AGateway* OutGateway, ULevelStreaming* Level, AGateway* InGateway, bool DeleteGateways = true);
+
+private:
+	// gateways of an already loaded level
+	static TArray<AGateway*> FindGateways(ULevelStreaming* Level);
 };
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GenerationManifest.h"
+#include "ReplacementLevelRegistry.h"
+#include "GeneratedLevelIndex.h"
 
 
 class EDITORWINDOW_API PluginManager
@@ -17,14 +20,27 @@ protected:
 	static inline unsigned short PIEFolderNameCounter;
 
 	// original levels and their replacement levels
-	static inline TMap<ULevelStreaming*, TSet<ULevelStreaming*>> ReplacementLevels;
+	static inline FReplacementLevelRegistry ReplacementLevels;
+
+	// all streaming levels spawned by the generator
+	static inline FGeneratedLevelIndex GeneratedLevels;
 
 	// actors and their replacement blueprint actors
 	static inline TMap<AActor*, AActor*> ReplacementActors;
 
+	// folders created for generated levels and how many levels are still in them
+	static inline TMap<FName, int32> GeneratedFolders;
+
+	// record of the current generation result, used to save and re-apply it
+	static inline FGenerationManifest Manifest;
+
 public:
 	static UDataTable* GetLevelsDataTable();
 
+	static const FGenerationManifest& GetManifest();
+
+	static FGeneratedLevelIndex& GetGeneratedLevels();
+
 	// get all sublevels contained in a world
 	static void GetAllLevels(UWorld* world, TSet<ULevelStreaming*>& OutLevels);
 
@@ -40,6 +56,13 @@ public:
 	// fully remove level from the editor world
 	static void UnloadFullLevel(ULevelStreaming* LevelStream);
 
+	// remove empty generator folders from the level browser
 	static void CleanupFolders();
 
+	// forget the level in its generator folder, the folder is removed once it's empty
+	static void ReleaseFolder(ULevelStreaming* LevelStream);
+
+	// force a full garbage collection, counted in stat DungeonGen
+	static void ForceGarbageCollection();
+
 };
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Runs python generator scripts in the persistent __main__ scope of the python plugin instead of
+// a fresh "py <file>" console command per run. A script is only executed again when the file changes;
+// if it defines a generate() function, later runs just call it, so imports and module level caches stay warm.
+class EDITORWINDOW_API FPythonGeneratorContext
+{
+public:
+	// run the script, returns false if python is not available or the script failed
+	bool Run(const FString& ScriptPath);
+
+	// forget the loaded script, the next run executes the file again
+	void Reset();
+
+private:
+	bool Exec(const FString& Command, bool bExecuteFile, FString* OutResult = nullptr);
+
+	FString LoadedScript;
+	FDateTime LoadedTimestamp;
+	bool bHasEntryPoint = false;
+};
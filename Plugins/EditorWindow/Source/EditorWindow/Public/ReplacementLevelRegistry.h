@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ULevel;
+class ULevelStreaming;
+
+// Layout levels and the replacement levels generated for them, indexed both ways (layout -> replacements and
+// replacement -> layout). Levels removed from the world are queued by the level removed event, so reconciling
+// manual deletions only touches the levels that were actually removed.
+class EDITORWINDOW_API FReplacementLevelRegistry
+{
+public:
+	FReplacementLevelRegistry() = default;
+	UE_NONCOPYABLE(FReplacementLevelRegistry);
+
+	// register the replacement levels of a layout level (replaces existing ones)
+	void Add(ULevelStreaming* LayoutLevel, const TSet<ULevelStreaming*>& Replacements);
+
+	// unregister a layout level, returns its replacement levels
+	TSet<ULevelStreaming*> RemoveLayout(ULevelStreaming* LayoutLevel);
+
+	// unregister a single replacement level
+	void RemoveReplacement(ULevelStreaming* ReplacementLevel);
+
+	bool Contains(ULevelStreaming* LayoutLevel) const { return Replacements.Contains(LayoutLevel); }
+
+	// layout level a replacement level was generated for, nullptr if it isn't a registered replacement
+	ULevelStreaming* FindOwner(ULevelStreaming* ReplacementLevel) const;
+
+	const TMap<ULevelStreaming*, TSet<ULevelStreaming*>>& GetAll() const { return Replacements; }
+
+	void Empty();
+
+	// stop listening to the level events, called when the module shuts down; the registry is a static and its
+	// destructor runs after the world delegates may already be gone
+	void Unbind();
+
+	// handle the registered levels removed since the last call; OnLayoutRemoved gets the replacements that are left
+	// without a layout level, removed replacements are just unregistered
+	void ProcessRemovedLevels(TFunctionRef<void(ULevelStreaming* LayoutLevel, const TSet<ULevelStreaming*>& Orphans)> OnLayoutRemoved);
+
+private:
+	void Bind();
+	void TrackLevel(ULevelStreaming* LevelStream);
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+	void OnLevelRemoved(ULevel* Level, UWorld* World);
+
+	TMap<ULevelStreaming*, TSet<ULevelStreaming*>> Replacements;
+	TMap<ULevelStreaming*, ULevelStreaming*> Owners;
+
+	// loaded level of every registered stream, to map the level removed event back to its stream
+	TMap<ULevel*, ULevelStreaming*> StreamOfLevel;
+
+	// registered streams whose level got removed, handled by ProcessRemovedLevels
+	TArray<ULevelStreaming*> RemovedLevels;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
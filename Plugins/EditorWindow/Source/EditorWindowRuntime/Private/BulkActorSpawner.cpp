@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BulkActorSpawner.h"
+#include "EditorWindowRuntime.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Bulk Spawn"), STAT_DungeonGen_BulkSpawn, STATGROUP_DungeonGen);
+
+TArray<AActor*> FBulkActorSpawner::SpawnActors(UWorld* World, TConstArrayView<FActorSpawnRequest> Requests)
+{
+	TArray<AActor*> SpawnedActors;
+	if (World == nullptr) return SpawnedActors;
+
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_BulkSpawn);
+
+	const double StartTime = FPlatformTime::Seconds();
+	SpawnedActors.Reserve(Requests.Num());
+
+	// create all actors, construction scripts and BeginPlay wait for the second pass
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.bDeferConstruction = true;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (const FActorSpawnRequest& Request : Requests)
+	{
+		SpawnParams.OverrideLevel = Request.Level;
+		SpawnedActors.Add(Request.Class ? World->SpawnActor(Request.Class, &Request.Transform, SpawnParams) : nullptr);
+	}
+
+	// finish the whole batch
+	int32 NumSpawned = 0;
+	for (int32 Index = 0; Index < SpawnedActors.Num(); Index++)
+	{
+		if (SpawnedActors[Index] == nullptr) continue;
+		SpawnedActors[Index]->FinishSpawning(Requests[Index].Transform);
+		NumSpawned++;
+	}
+	INC_DWORD_STAT_BY(STAT_DungeonGen_ActorsSpawned, NumSpawned);
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogDungeonGen, Verbose, TEXT("Bulk spawned %d actors in %.2f ms (%.0f actors/s)"),
+		SpawnedActors.Num(), Seconds * 1000.0, Seconds > 0.0 ? SpawnedActors.Num() / Seconds : 0.0);
+
+	return SpawnedActors;
+}
+
+#if !UE_BUILD_SHIPPING
+
+// DungeonGen.BenchmarkSpawn [Count] [Class]: spawn Count actors one by one and in a batch, log the throughput of both
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkSpawnCommand(
+	TEXT("DungeonGen.BenchmarkSpawn"),
+	TEXT("Spawn Count (default 10000) actors of Class (default Actor) one by one and in a batch, and log the spawn throughput."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr) return;
+
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+		UClass* ActorClass = Args.Num() > 1 ? FindFirstObject<UClass>(*Args[1], EFindFirstObjectOptions::ExactClass) : AActor::StaticClass();
+		if (Count <= 0 || ActorClass == nullptr || !ActorClass->IsChildOf<AActor>()) return;
+
+		TArray<FActorSpawnRequest> Requests;
+		Requests.Reserve(Count);
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			FActorSpawnRequest& Request = Requests.AddDefaulted_GetRef();
+			Request.Class = ActorClass;
+			Request.Transform.SetLocation(FVector(Index % 100, Index / 100, 0) * 100.0);
+		}
+
+		auto DestroyAll = [](TArray<AActor*>& Actors)
+		{
+			for (AActor* Actor : Actors)
+			{
+				if (Actor) Actor->Destroy();
+			}
+			Actors.Reset();
+		};
+
+		// one by one, the way the replacement passes used to spawn
+		TArray<AActor*> Actors;
+		double StartTime = FPlatformTime::Seconds();
+		for (const FActorSpawnRequest& Request : Requests)
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			Actors.Add(World->SpawnActor(Request.Class, &Request.Transform, SpawnParams));
+		}
+		const double SingleSeconds = FPlatformTime::Seconds() - StartTime;
+		DestroyAll(Actors);
+
+		StartTime = FPlatformTime::Seconds();
+		Actors = FBulkActorSpawner::SpawnActors(World, Requests);
+		const double BulkSeconds = FPlatformTime::Seconds() - StartTime;
+		DestroyAll(Actors);
+
+		UE_LOG(LogDungeonGen, Display, TEXT("Spawn benchmark (%d x %s): one by one %.2f ms (%.0f actors/s), bulk %.2f ms (%.0f actors/s)"),
+			Count, *ActorClass->GetName(),
+			SingleSeconds * 1000.0, Count / FMath::Max(SingleSeconds, UE_SMALL_NUMBER),
+			BulkSeconds * 1000.0, Count / FMath::Max(BulkSeconds, UE_SMALL_NUMBER));
+	}));
+
+#endif
@@ -0,0 +1,593 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DungeonGenerationSubsystem.h"
+#include "EditorWindowRuntime.h"
+#include "GeneratorSelection.h"
+#include "GeneratorTypes.h"
+#include "BulkActorSpawner.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "LevelUtils.h"
+
+DECLARE_CYCLE_STAT(TEXT("Room Selection"), STAT_DungeonGen_RoomSelection, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Actor Selection"), STAT_DungeonGen_ActorSelection, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Room Instancing"), STAT_DungeonGen_RoomInstancing, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Actor Snapshot"), STAT_DungeonGen_ActorSnapshot, STATGROUP_DungeonGen);
+DECLARE_CYCLE_STAT(TEXT("Replacement Spawning"), STAT_DungeonGen_ReplacementSpawning, STATGROUP_DungeonGen);
+
+namespace
+{
+	// layout level with a matching levels datatable row, copied so the selection can run off the game thread
+	struct FLayoutSlot
+	{
+		int32 LayoutIndex = INDEX_NONE;
+		FManifestLevelRef LayoutRef;
+		TSet<FWeightedWorld> ReplaceWorlds;
+		int32 SumOfWeights = 0;
+	};
+
+	// actors found for a single tags/actors datatable row (per level for tags)
+	struct FActorGroup
+	{
+		TArray<TWeakObjectPtr<AActor>> Actors;
+
+		// tags row: keep this many actors and replace them with ReplaceActor
+		bool bTagGroup = false;
+		int32 NumberOfElements = 0;
+		UClass* ReplaceActor = nullptr;
+
+		// actors row: replace every actor with a weighted random class
+		TSet<FWeightedActor> ReplaceActors;
+		int32 SumOfWeights = 0;
+
+		// filled on the background thread, one class per actor (nullptr if the actor isn't replaced)
+		TArray<UClass*> Picks;
+	};
+
+	// same choices as the editor tags pass: a random subset of NumberOfElements actors is kept
+	void SelectTagGroup(FActorGroup& Group, FRandomStream& RandomStream)
+	{
+		TArray<int32> Indices;
+		Indices.Reserve(Group.Actors.Num());
+		for (int32 Index = 0; Index < Group.Actors.Num(); Index++)
+		{
+			Indices.Add(Index);
+		}
+
+		const int32 NumSelected = GeneratorSelection::SelectRandomSubset(Indices, Group.NumberOfElements, RandomStream);
+
+		Group.Picks.Init(nullptr, Group.Actors.Num());
+		for (int32 Index = 0; Index < NumSelected; Index++)
+		{
+			Group.Picks[Indices[Index]] = Group.ReplaceActor;
+		}
+	}
+
+	void SelectActorGroup(FActorGroup& Group, FRandomStream& RandomStream)
+	{
+		Group.Picks.Init(nullptr, Group.Actors.Num());
+		for (int32 Index = 0; Index < Group.Actors.Num(); Index++)
+		{
+			const FWeightedActor* Pick = GeneratorSelection::WeightedRandom(Group.ReplaceActors, RandomStream, Group.SumOfWeights);
+			Group.Picks[Index] = Pick ? Pick->Actor.Get() : nullptr;
+		}
+	}
+
+	// name the replacement folder with the same name as the layout level, like the editor does
+	FString GetFolderName(const ULevelStreaming* LayoutLevel)
+	{
+		if (LayoutLevel == nullptr) return "";
+
+		TArray<FString> Parse;
+		LayoutLevel->GetWorldAssetPackageName().ParseIntoArray(Parse, TEXT("/"));
+		return Parse.Num() > 0 ? Parse.Last() : "";
+	}
+}
+
+bool UDungeonGenerationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// the editor world is handled by the editor window
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDungeonGenerationSubsystem::Deinitialize()
+{
+	RunId++;
+	Phase = EPhase::Idle;
+
+	Super::Deinitialize();
+}
+
+TStatId UDungeonGenerationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDungeonGenerationSubsystem, STATGROUP_Tickables);
+}
+
+bool UDungeonGenerationSubsystem::GenerateDungeon(const FDungeonGenerationSettings& Settings)
+{
+	if (IsGenerating()) return false;
+	if (Settings.LevelsDataTable == nullptr)
+	{
+		UE_LOG(LogDungeonGen, Warning, TEXT("Levels DataTable is empty!"));
+		return false;
+	}
+
+	ClearDungeon();
+
+	CurrentSettings = Settings;
+	bFromManifest = false;
+	Stats = FDungeonGenerationStats();
+	RunStartTime = FPlatformTime::Seconds();
+	PhaseStartTime = RunStartTime;
+
+	// truncate random seeds the same way the editor does, so a logged seed can be typed into the editor window
+	if (CurrentSettings.Seed == 0)
+	{
+		FRandomStream RandomStream;
+		RandomStream.GenerateNewSeed();
+		CurrentSettings.Seed = FMath::Max(1, RandomStream.GetCurrentSeed() & 0xFFFF);
+	}
+
+	Manifest.LevelsSeed = Manifest.TagsSeed = Manifest.ActorsSeed = CurrentSettings.Seed;
+	Manifest.LevelsDataTableHash = FGenerationManifest::HashDataTable(Settings.LevelsDataTable);
+	Manifest.TagsDataTableHash = FGenerationManifest::HashDataTable(Settings.TagsDataTable);
+	Manifest.ActorsDataTableHash = FGenerationManifest::HashDataTable(Settings.ActorsDataTable);
+
+	// snapshot the layout levels and their rows on the game thread
+	LevelIdentities.Update(Settings.LevelsDataTable);
+
+	TArray<FLayoutSlot> Slots;
+	LayoutLevels = GetWorld()->GetStreamingLevels();
+	const TMap<const ULevelStreaming*, FManifestLevelRef> LayoutRefs = GeneratorSelection::MakeLevelRefs(GetWorld());
+	for (int32 LayoutIndex = 0; LayoutIndex < LayoutLevels.Num(); LayoutIndex++)
+	{
+		const FLevelsStruct* RowData = Settings.LevelsDataTable->FindRow<FLevelsStruct>(LevelIdentities.FindRow(LayoutLevels[LayoutIndex]), TEXT(""), false);
+		if (RowData == nullptr) continue;
+
+		FLayoutSlot& Slot = Slots.AddDefaulted_GetRef();
+		Slot.LayoutIndex = LayoutIndex;
+		Slot.LayoutRef = LayoutRefs.FindRef(LayoutLevels[LayoutIndex]);
+		Slot.ReplaceWorlds = RowData->ReplaceWorlds;
+		Slot.SumOfWeights = GeneratorSelection::SumOfWeights(Slot.ReplaceWorlds);
+
+		if (Slot.SumOfWeights == 0)
+		{
+			UE_LOG(LogDungeonGen, Warning, TEXT("All replacement worlds of '%s' have a weight value of zero. No replacement world will be generated!"),
+				*LayoutLevels[LayoutIndex]->GetWorldAssetPackageName());
+			Slots.Pop();
+		}
+	}
+
+	Phase = EPhase::Selecting;
+
+	// weighted selection off the game thread, streaming starts back on the game thread
+	const uint32 SelectionRunId = ++RunId;
+	const int32 Seed = CurrentSettings.Seed;
+	TWeakObjectPtr<UDungeonGenerationSubsystem> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, SelectionRunId, Seed, Slots = MoveTemp(Slots)]()
+	{
+		DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_RoomSelection);
+
+		// every layout level draws from its own stream, so the slots can be selected in parallel
+		TArray<FRoomChoice> Choices;
+		Choices.SetNum(Slots.Num());
+
+		ParallelFor(Slots.Num(), [&Slots, &Choices, Seed](int32 Index)
+		{
+			const FLayoutSlot& Slot = Slots[Index];
+			FRandomStream RandomStream = GeneratorSelection::MakeLevelRandomStream(Seed, Slot.LayoutRef);
+
+			const FWeightedWorld* Pick = GeneratorSelection::WeightedRandom(Slot.ReplaceWorlds, RandomStream, Slot.SumOfWeights);
+			if (Pick == nullptr) return;
+
+			FRoomChoice& Choice = Choices[Index];
+			Choice.LayoutIndex = Slot.LayoutIndex;
+			Choice.LayoutRef = Slot.LayoutRef;
+			Choice.World = Pick->World;
+		});
+
+		Choices.RemoveAll([](const FRoomChoice& Choice) { return Choice.LayoutIndex == INDEX_NONE; });
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SelectionRunId, Choices = MoveTemp(Choices)]() mutable
+		{
+			UDungeonGenerationSubsystem* This = WeakThis.Get();
+			if (This == nullptr || This->RunId != SelectionRunId) return;
+
+			This->OnRoomsSelected(MoveTemp(Choices));
+		});
+	});
+
+	return true;
+}
+
+bool UDungeonGenerationSubsystem::GenerateFromManifest(const FGenerationManifest& InManifest)
+{
+	if (IsGenerating()) return false;
+
+	ClearDungeon();
+
+	Manifest = InManifest;
+	bFromManifest = true;
+	Stats = FDungeonGenerationStats();
+	RunStartTime = FPlatformTime::Seconds();
+	PhaseStartTime = RunStartTime;
+	RunId++;
+
+	LayoutLevels = GetWorld()->GetStreamingLevels();
+	for (const FManifestLevelEntry& Entry : Manifest.Levels)
+	{
+		ULevelStreaming* LayoutLevel = GeneratorSelection::ResolveLevelRef(GetWorld(), Entry.LayoutLevel);
+		LoadRoom(TSoftObjectPtr<UWorld>(FSoftObjectPath(Entry.ReplaceWorldPath)), Entry.Transform, LayoutLevel);
+	}
+
+	Phase = EPhase::Streaming;
+	return true;
+}
+
+bool UDungeonGenerationSubsystem::GenerateFromManifestFile(const FString& FilePath)
+{
+	FGenerationManifest LoadedManifest;
+	if (!LoadedManifest.LoadFromFile(FilePath))
+	{
+		UE_LOG(LogDungeonGen, Warning, TEXT("Failed to read generation manifest '%s'!"), *FilePath);
+		return false;
+	}
+
+	return GenerateFromManifest(LoadedManifest);
+}
+
+void UDungeonGenerationSubsystem::ClearDungeon()
+{
+	RunId++;
+	Phase = EPhase::Idle;
+
+	for (AActor* SpawnedActor : SpawnedActors)
+	{
+		if (IsValid(SpawnedActor)) SpawnedActor->Destroy();
+	}
+
+	for (ULevelStreaming* GeneratedLevel : GeneratedLevels)
+	{
+		if (IsValid(GeneratedLevel)) GeneratedLevel->SetIsRequestingUnloadAndRemoval(true);
+	}
+
+	SpawnedActors.Empty();
+	SpawnedActorSources.Empty();
+	GeneratedLevels.Empty();
+	PendingRooms.Empty();
+	Manifest.Reset();
+}
+
+void UDungeonGenerationSubsystem::OnRoomsSelected(TArray<FRoomChoice> Choices)
+{
+	const double Now = FPlatformTime::Seconds();
+	Stats.SelectionSeconds = Now - PhaseStartTime;
+	PhaseStartTime = Now;
+
+	for (const FRoomChoice& Choice : Choices)
+	{
+		ULevelStreaming* LayoutLevel = LayoutLevels[Choice.LayoutIndex];
+		if (!IsValid(LayoutLevel)) continue;
+
+		if (LoadRoom(Choice.World, LayoutLevel->LevelTransform, LayoutLevel) == nullptr) continue;
+
+		FManifestLevelEntry Entry;
+		Entry.LayoutLevel = Choice.LayoutRef;
+		Entry.ReplaceWorldPath = Choice.World.ToSoftObjectPath().ToString();
+		Entry.FolderName = GetFolderName(LayoutLevel);
+		Entry.Transform = LayoutLevel->LevelTransform;
+		Entry.Color = LayoutLevel->LevelColor;
+		Manifest.SetLevel(Entry);
+	}
+
+	Phase = EPhase::Streaming;
+}
+
+ULevelStreaming* UDungeonGenerationSubsystem::LoadRoom(const TSoftObjectPtr<UWorld>& World, const FTransform& Transform, ULevelStreaming* LayoutLevel)
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_RoomInstancing);
+
+	bool bSuccess = false;
+	ULevelStreamingDynamic* RoomStream = ULevelStreamingDynamic::LoadLevelInstanceBySoftObjectPtr(GetWorld(),
+																								   World,
+																								   Transform.GetLocation(),
+																								   Transform.Rotator(),
+																								   bSuccess);
+	if (!bSuccess || RoomStream == nullptr)
+	{
+		UE_LOG(LogDungeonGen, Warning, TEXT("Failed to load room '%s'!"), *World.ToString());
+		return nullptr;
+	}
+
+	// the room takes the place of the layout level
+	if (IsValid(LayoutLevel))
+	{
+		LayoutLevel->SetShouldBeVisible(false);
+		LayoutLevel->SetShouldBeLoaded(false);
+	}
+
+	GeneratedLevels.Add(RoomStream);
+	PendingRooms.Add(RoomStream);
+	Stats.LevelsLoaded++;
+	INC_DWORD_STAT(STAT_DungeonGen_LevelsLoaded);
+
+	return RoomStream;
+}
+
+bool UDungeonGenerationSubsystem::LoadNestedLevels(ULevelStreaming* RoomStream)
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_RoomInstancing);
+
+	ULevel* RoomLevel = RoomStream->GetLoadedLevel();
+	UWorld* RoomWorld = RoomLevel ? RoomLevel->GetTypedOuter<UWorld>() : nullptr;
+	if (RoomWorld == nullptr) return false;
+
+	// sublevels of a streamed world aren't streamed with it, instance them relative to the room
+	bool bHasNestedLevels = false;
+	for (ULevelStreaming* NestedLevel : RoomWorld->GetStreamingLevels())
+	{
+		if (NestedLevel == nullptr) continue;
+
+		const FTransform Transform = NestedLevel->LevelTransform * RoomStream->LevelTransform;
+
+		bool bSuccess = false;
+		ULevelStreamingDynamic* NestedStream = ULevelStreamingDynamic::LoadLevelInstanceBySoftObjectPtr(GetWorld(),
+																										 NestedLevel->GetWorldAsset(),
+																										 Transform.GetLocation(),
+																										 Transform.Rotator(),
+																										 bSuccess);
+		if (!bSuccess || NestedStream == nullptr) continue;
+
+		GeneratedLevels.Add(NestedStream);
+		Stats.LevelsLoaded++;
+		INC_DWORD_STAT(STAT_DungeonGen_LevelsLoaded);
+		bHasNestedLevels = true;
+	}
+
+	return bHasNestedLevels;
+}
+
+void UDungeonGenerationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Phase != EPhase::Streaming) return;
+
+	// instance the sublevels of the rooms that finished streaming in
+	for (int32 Index = 0; Index < PendingRooms.Num();)
+	{
+		ULevelStreaming* RoomStream = PendingRooms[Index];
+		if (IsValid(RoomStream) && !RoomStream->IsLevelVisible() &&
+			RoomStream->GetCurrentState() != ULevelStreaming::ECurrentState::FailedToLoad)
+		{
+			Index++;
+			continue;
+		}
+
+		if (IsValid(RoomStream) && RoomStream->IsLevelVisible()) LoadNestedLevels(RoomStream);
+		PendingRooms.RemoveAt(Index);
+	}
+
+	if (PendingRooms.Num() > 0) return;
+
+	for (ULevelStreaming* GeneratedLevel : GeneratedLevels)
+	{
+		if (IsValid(GeneratedLevel) && !GeneratedLevel->IsLevelVisible() &&
+			GeneratedLevel->GetCurrentState() != ULevelStreaming::ECurrentState::FailedToLoad) return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	Stats.StreamingSeconds = Now - PhaseStartTime;
+	PhaseStartTime = Now;
+
+	Phase = EPhase::Spawning;
+	if (bFromManifest)
+	{
+		ApplyManifestActors();
+		FinishGeneration();
+	}
+	else
+	{
+		GenerateActors();
+	}
+}
+
+void UDungeonGenerationSubsystem::GenerateActors()
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_ActorSnapshot);
+
+	UWorld* World = GetWorld();
+	TArray<FActorGroup> Groups;
+
+	// snapshot the tagged actors, grouped per level like the editor tags pass
+	if (CurrentSettings.TagsDataTable)
+	{
+		for (const TPair<FName, uint8*>& Row : CurrentSettings.TagsDataTable->GetRowMap())
+		{
+			const FTagsStruct* RowData = (const FTagsStruct*)Row.Value;
+
+			TArray<AActor*> FoundActors;
+			UGameplayStatics::GetAllActorsWithTag(World, RowData->ActorTag, FoundActors);
+			if (FoundActors.Num() == 0) continue;
+
+			if (FoundActors.Num() < RowData->NumberOfElements)
+			{
+				UE_LOG(LogDungeonGen, Warning, TEXT("Tag '%s' has less than %d actors in the level!"), *RowData->ActorTag.ToString(), RowData->NumberOfElements);
+				continue;
+			}
+
+			TMap<ULevel*, int32> GroupOfLevel;
+			for (AActor* FoundActor : FoundActors)
+			{
+				int32* GroupIndex = GroupOfLevel.Find(FoundActor->GetLevel());
+				if (GroupIndex == nullptr)
+				{
+					GroupIndex = &GroupOfLevel.Add(FoundActor->GetLevel(), Groups.Num());
+
+					FActorGroup& Group = Groups.AddDefaulted_GetRef();
+					Group.bTagGroup = true;
+					Group.NumberOfElements = RowData->NumberOfElements;
+					Group.ReplaceActor = RowData->ReplaceActor;
+				}
+				Groups[*GroupIndex].Actors.Add(FoundActor);
+			}
+		}
+	}
+
+	if (CurrentSettings.ActorsDataTable)
+	{
+		for (const TPair<FName, uint8*>& Row : CurrentSettings.ActorsDataTable->GetRowMap())
+		{
+			const FActorsStruct* RowData = (const FActorsStruct*)Row.Value;
+
+			FActorGroup Group;
+			Group.ReplaceActors = RowData->ReplaceActors;
+			Group.SumOfWeights = GeneratorSelection::SumOfWeights(Group.ReplaceActors);
+			if (Group.SumOfWeights == 0)
+			{
+				UE_LOG(LogDungeonGen, Warning, TEXT("All replacement actors listed under the '%s' row have a weight value of zero. No replacement actor will be generated!"), *Row.Key.ToString());
+				continue;
+			}
+
+			TArray<AActor*> FoundActors;
+			UGameplayStatics::GetAllActorsOfClass(World, RowData->Actor, FoundActors);
+			if (FoundActors.Num() == 0) continue;
+
+			Group.Actors.Append(FoundActors);
+			Groups.Add(MoveTemp(Group));
+		}
+	}
+
+	const uint32 SelectionRunId = RunId;
+	const int32 Seed = CurrentSettings.Seed;
+	TWeakObjectPtr<UDungeonGenerationSubsystem> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, SelectionRunId, Seed, Groups = MoveTemp(Groups)]() mutable
+	{
+		DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_ActorSelection);
+
+		// separate streams for tags and actors, same as the two editor passes
+		FRandomStream TagsRandomStream(Seed);
+		FRandomStream ActorsRandomStream(Seed);
+
+		for (FActorGroup& Group : Groups)
+		{
+			if (Group.bTagGroup) SelectTagGroup(Group, TagsRandomStream);
+			else SelectActorGroup(Group, ActorsRandomStream);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SelectionRunId, Groups = MoveTemp(Groups)]()
+		{
+			UDungeonGenerationSubsystem* This = WeakThis.Get();
+			if (This == nullptr || This->RunId != SelectionRunId) return;
+
+			TArray<AActor*> SourceActors;
+			TArray<FActorSpawnRequest> SpawnRequests;
+			for (const FActorGroup& Group : Groups)
+			{
+				for (int32 Index = 0; Index < Group.Actors.Num(); Index++)
+				{
+					AActor* SourceActor = Group.Actors[Index].Get();
+					if (SourceActor == nullptr) continue;
+
+					if (Group.Picks[Index])
+					{
+						SourceActors.Add(SourceActor);
+						SpawnRequests.Add({ Group.Picks[Index], SourceActor->GetActorTransform(), SourceActor->GetLevel() });
+					}
+					// spawn points that weren't picked are removed too, like merging in the editor
+					else if (Group.bTagGroup) SourceActor->Destroy();
+				}
+			}
+
+			This->SpawnReplacements(SourceActors, SpawnRequests);
+			This->FinishGeneration();
+		});
+	});
+}
+
+void UDungeonGenerationSubsystem::ApplyManifestActors()
+{
+	UWorld* World = GetWorld();
+
+	TArray<AActor*> SourceActors;
+	TArray<FActorSpawnRequest> SpawnRequests;
+	for (const FManifestActorEntry& Entry : Manifest.Actors)
+	{
+		ULevel* Level = World->PersistentLevel;
+		if (Entry.Level.PackageKey != NAME_None)
+		{
+			ULevelStreaming* LevelStream = GeneratorSelection::ResolveLevelRef(World, Entry.Level);
+			Level = LevelStream ? LevelStream->GetLoadedLevel() : nullptr;
+		}
+		if (Level == nullptr) continue;
+
+		UClass* ReplaceActorClass = TSoftClassPtr<AActor>(FSoftObjectPath(Entry.ReplaceActorClassPath)).LoadSynchronous();
+		AActor* SourceActor = FindObject<AActor>(Level, *Entry.SourceActorName.ToString());
+		if (ReplaceActorClass == nullptr || SourceActor == nullptr) continue;
+
+		SourceActors.Add(SourceActor);
+		SpawnRequests.Add({ ReplaceActorClass, Entry.Transform, Level });
+	}
+
+	SpawnReplacements(SourceActors, SpawnRequests);
+}
+
+void UDungeonGenerationSubsystem::SpawnReplacements(const TArray<AActor*>& SourceActors, const TArray<FActorSpawnRequest>& SpawnRequests)
+{
+	DUNGEONGEN_SCOPE_CYCLE_COUNTER(STAT_DungeonGen_ReplacementSpawning);
+
+	const TArray<AActor*> ReplacementActors = FBulkActorSpawner::SpawnActors(GetWorld(), SpawnRequests);
+
+	for (int32 Index = 0; Index < ReplacementActors.Num(); Index++)
+	{
+		AActor* SourceActor = SourceActors[Index];
+		if (ReplacementActors[Index] == nullptr) continue;
+
+		SpawnedActors.Add(ReplacementActors[Index]);
+		Stats.ActorsSpawned++;
+
+		ULevelStreaming* LevelStream = FLevelUtils::FindStreamingLevel(SourceActor->GetLevel());
+		const FManifestLevelRef LevelRef = LevelStream ? GeneratorSelection::MakeLevelRef(GetWorld(), LevelStream) : FManifestLevelRef();
+		SpawnedActorSources.Add(ReplacementActors[Index], { LevelRef, SourceActor->GetFName() });
+
+		if (!bFromManifest)
+		{
+			FManifestActorEntry Entry;
+			Entry.Level = LevelRef;
+			Entry.SourceActorName = SourceActor->GetFName();
+			Entry.ReplaceActorClassPath = SpawnRequests[Index].Class->GetPathName();
+			Entry.Transform = SpawnRequests[Index].Transform;
+			Manifest.SetActor(Entry);
+		}
+
+		// the replaced actor is removed, like merging in the editor
+		SourceActor->Destroy();
+	}
+}
+
+bool UDungeonGenerationSubsystem::GetSpawnedActorSource(const AActor* SpawnedActor, FManifestLevelRef& OutLevel, FName& OutSourceActorName) const
+{
+	const TPair<FManifestLevelRef, FName>* Source = SpawnedActorSources.Find(SpawnedActor);
+	if (Source == nullptr) return false;
+
+	OutLevel = Source->Key;
+	OutSourceActorName = Source->Value;
+	return true;
+}
+
+void UDungeonGenerationSubsystem::FinishGeneration()
+{
+	const double Now = FPlatformTime::Seconds();
+	Stats.SpawningSeconds = Now - PhaseStartTime;
+	Stats.TotalSeconds = Now - RunStartTime;
+	Phase = EPhase::Idle;
+
+	UE_LOG(LogDungeonGen, Log, TEXT("Dungeon generated (seed %d): %d levels, %d actors in %.3fs (selection %.3fs, streaming %.3fs, spawning %.3fs)"),
+		Manifest.LevelsSeed, Stats.LevelsLoaded, Stats.ActorsSpawned, Stats.TotalSeconds,
+		Stats.SelectionSeconds, Stats.StreamingSeconds, Stats.SpawningSeconds);
+
+	OnDungeonGenerated.Broadcast(Stats);
+}
@@ -0,0 +1,357 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DungeonGenerator.h"
+#include "GeneratorSelection.h"
+#include "Engine/DataTable.h"
+
+namespace
+{
+	const FIntPoint GridDirections[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+
+	// grid the rooms are placed on, built from the input bounds
+	struct FRoomGrid
+	{
+		FRoomGrid(const FDungeonGeneratorInput& Input)
+			: Origin(Input.Bounds.Min)
+			, CellSize(FMath::Max(Input.CellSize, 1.f))
+		{
+			const FVector Size = Input.Bounds.GetSize();
+			Dimensions.X = FMath::FloorToInt(Size.X / CellSize);
+			Dimensions.Y = FMath::FloorToInt(Size.Y / CellSize);
+		}
+
+		bool IsValid() const { return Dimensions.X > 0 && Dimensions.Y > 0; }
+		int32 NumCells() const { return Dimensions.X * Dimensions.Y; }
+
+		bool Contains(const FIntPoint& Cell) const
+		{
+			return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Dimensions.X && Cell.Y < Dimensions.Y;
+		}
+
+		FVector GetLocation(const FIntPoint& Cell) const
+		{
+			return FVector(Origin.X + (Cell.X + 0.5f) * CellSize, Origin.Y + (Cell.Y + 0.5f) * CellSize, Origin.Z);
+		}
+
+		FVector Origin;
+		float CellSize;
+		FIntPoint Dimensions = FIntPoint::ZeroValue;
+	};
+
+	// picks the room worlds of the layout
+	struct FRoomPicker
+	{
+		FRoomPicker(const FDungeonGeneratorInput& Input)
+			: Pool(FDungeonGeneratorRegistry::GetRoomPool(Input.LevelsDataTable))
+			, SumOfWeights(GeneratorSelection::SumOfWeights(Pool))
+		{
+		}
+
+		bool IsValid() const { return SumOfWeights > 0; }
+
+		TSoftObjectPtr<UWorld> Pick(FRandomStream& RandomStream) const
+		{
+			const FWeightedWorld* Picked = GeneratorSelection::WeightedRandom(Pool, RandomStream, SumOfWeights);
+			return Picked ? Picked->World : TSoftObjectPtr<UWorld>();
+		}
+
+		TSet<FWeightedWorld> Pool;
+		int32 SumOfWeights;
+	};
+
+	int32 AddRoom(FDungeonLayout& Layout, const FRoomGrid& Grid, const FIntPoint& Cell, const FRoomPicker& Picker, FRandomStream& RandomStream)
+	{
+		FDungeonLayoutRoom& Room = Layout.Rooms.AddDefaulted_GetRef();
+		Room.World = Picker.Pick(RandomStream);
+		Room.Transform.SetLocation(Grid.GetLocation(Cell));
+		return Layout.Rooms.Num() - 1;
+	}
+
+	void AddConnection(FDungeonLayout& Layout, int32 A, int32 B)
+	{
+		if (A == B) return;
+		if (Layout.Connections.Contains(TPair<int32, int32>(A, B)) || Layout.Connections.Contains(TPair<int32, int32>(B, A))) return;
+		Layout.Connections.Emplace(A, B);
+	}
+
+	// walks the grid from its center, every newly visited cell becomes a room
+	class FRandomWalkGenerator : public IDungeonGenerator
+	{
+	public:
+		virtual FName GetName() const override { return "RandomWalk"; }
+
+		virtual bool Generate(const FDungeonGeneratorInput& Input, FDungeonLayout& OutLayout) const override
+		{
+			const FRoomGrid Grid(Input);
+			const FRoomPicker Picker(Input);
+			if (!Grid.IsValid() || !Picker.IsValid()) return false;
+
+			FRandomStream RandomStream(Input.Seed);
+			const int32 NumRooms = FMath::Min(Input.NumRooms, Grid.NumCells());
+
+			TMap<FIntPoint, int32> Occupied;
+			FIntPoint Cell(Grid.Dimensions.X / 2, Grid.Dimensions.Y / 2);
+			Occupied.Add(Cell, AddRoom(OutLayout, Grid, Cell, Picker, RandomStream));
+
+			// give up on walks that keep running into the bounds
+			const int32 MaxSteps = NumRooms * 100;
+			for (int32 Step = 0; Step < MaxSteps && OutLayout.Rooms.Num() < NumRooms; Step++)
+			{
+				const FIntPoint Next = Cell + GridDirections[RandomStream.RandRange(0, 3)];
+				if (!Grid.Contains(Next)) continue;
+
+				int32* NextRoom = Occupied.Find(Next);
+				const int32 NextIndex = NextRoom ? *NextRoom : Occupied.Add(Next, AddRoom(OutLayout, Grid, Next, Picker, RandomStream));
+
+				AddConnection(OutLayout, Occupied[Cell], NextIndex);
+				Cell = Next;
+			}
+
+			return true;
+		}
+	};
+
+	// splits the bounds into partitions until there is one per room, sibling partitions are connected
+	class FBSPGenerator : public IDungeonGenerator
+	{
+	public:
+		virtual FName GetName() const override { return "BSP"; }
+
+		virtual bool Generate(const FDungeonGeneratorInput& Input, FDungeonLayout& OutLayout) const override
+		{
+			const FRoomGrid Grid(Input);
+			const FRoomPicker Picker(Input);
+			if (!Grid.IsValid() || !Picker.IsValid()) return false;
+
+			FRandomStream RandomStream(Input.Seed);
+
+			// partitions in grid cells, Max is exclusive
+			TArray<FIntRect> Partitions;
+			Partitions.Emplace(FIntPoint::ZeroValue, Grid.Dimensions);
+
+			TArray<TPair<int32, int32>> Siblings;
+
+			while (Partitions.Num() < Input.NumRooms)
+			{
+				// split the largest partition along its longer side
+				int32 Largest = 0;
+				for (int32 Index = 1; Index < Partitions.Num(); Index++)
+				{
+					if (Partitions[Index].Area() > Partitions[Largest].Area()) Largest = Index;
+				}
+
+				const FIntRect Partition = Partitions[Largest];
+				if (Partition.Area() < 2) break;
+
+				const bool bSplitX = Partition.Width() >= Partition.Height();
+				const int32 Size = bSplitX ? Partition.Width() : Partition.Height();
+				const int32 Split = RandomStream.RandRange(1, Size - 1);
+
+				FIntRect First = Partition;
+				FIntRect Second = Partition;
+				if (bSplitX)
+				{
+					First.Max.X = Partition.Min.X + Split;
+					Second.Min.X = First.Max.X;
+				}
+				else
+				{
+					First.Max.Y = Partition.Min.Y + Split;
+					Second.Min.Y = First.Max.Y;
+				}
+
+				// the first half keeps the index, so earlier sibling pairs still connect the same subtrees
+				Partitions[Largest] = First;
+				Siblings.Emplace(Largest, Partitions.Add(Second));
+			}
+
+			for (const FIntRect& Partition : Partitions)
+			{
+				const FIntPoint Cell(RandomStream.RandRange(Partition.Min.X, Partition.Max.X - 1),
+									 RandomStream.RandRange(Partition.Min.Y, Partition.Max.Y - 1));
+				AddRoom(OutLayout, Grid, Cell, Picker, RandomStream);
+			}
+
+			for (const TPair<int32, int32>& Pair : Siblings)
+			{
+				AddConnection(OutLayout, Pair.Key, Pair.Value);
+			}
+
+			return true;
+		}
+	};
+
+	// grows a mission graph from start -> goal with rewrite rules, then lays the graph out on the grid
+	class FGraphGrammarGenerator : public IDungeonGenerator
+	{
+	public:
+		virtual FName GetName() const override { return "GraphGrammar"; }
+
+		virtual bool Generate(const FDungeonGeneratorInput& Input, FDungeonLayout& OutLayout) const override
+		{
+			const FRoomGrid Grid(Input);
+			const FRoomPicker Picker(Input);
+			if (!Grid.IsValid() || !Picker.IsValid()) return false;
+
+			FRandomStream RandomStream(Input.Seed);
+			const int32 NumRooms = FMath::Clamp(Input.NumRooms, 2, Grid.NumCells());
+
+			// node 0 is the start, node 1 the goal
+			int32 NumNodes = 2;
+			TArray<TPair<int32, int32>> Edges;
+			Edges.Emplace(0, 1);
+
+			while (NumNodes < NumRooms)
+			{
+				const int32 NewNode = NumNodes++;
+
+				// rule 1 (2/3): insert a room into a corridor, a -> b becomes a -> new -> b
+				if (RandomStream.RandRange(0, 2) != 0)
+				{
+					TPair<int32, int32>& Edge = Edges[RandomStream.RandRange(0, Edges.Num() - 1)];
+					const int32 End = Edge.Value;
+					Edge.Value = NewNode;
+					Edges.Emplace(NewNode, End);
+				}
+				// rule 2 (1/3): branch a side room off any room but the goal
+				else
+				{
+					int32 Parent = RandomStream.RandRange(0, NumNodes - 2);
+					if (Parent == 1) Parent = 0;
+					Edges.Emplace(Parent, NewNode);
+				}
+			}
+
+			TArray<TArray<int32>> Neighbours;
+			Neighbours.SetNum(NumNodes);
+			for (const TPair<int32, int32>& Edge : Edges)
+			{
+				Neighbours[Edge.Key].Add(Edge.Value);
+				Neighbours[Edge.Value].Add(Edge.Key);
+			}
+
+			// breadth first from the start, each room goes next to the room it was reached from
+			TArray<int32> RoomOfNode;
+			RoomOfNode.Init(INDEX_NONE, NumNodes);
+			TArray<FIntPoint> CellOfNode;
+			CellOfNode.SetNum(NumNodes);
+			TSet<FIntPoint> Occupied;
+
+			const FIntPoint StartCell(Grid.Dimensions.X / 2, Grid.Dimensions.Y / 2);
+			RoomOfNode[0] = AddRoom(OutLayout, Grid, StartCell, Picker, RandomStream);
+			CellOfNode[0] = StartCell;
+			Occupied.Add(StartCell);
+
+			TArray<int32> Queue = { 0 };
+			for (int32 QueueIndex = 0; QueueIndex < Queue.Num(); QueueIndex++)
+			{
+				const int32 Node = Queue[QueueIndex];
+				for (int32 Neighbour : Neighbours[Node])
+				{
+					if (RoomOfNode[Neighbour] != INDEX_NONE) continue;
+
+					FIntPoint Cell;
+					if (!FindFreeCell(Grid, Occupied, CellOfNode[Node], RandomStream, Cell)) return false;
+
+					RoomOfNode[Neighbour] = AddRoom(OutLayout, Grid, Cell, Picker, RandomStream);
+					CellOfNode[Neighbour] = Cell;
+					Occupied.Add(Cell);
+					Queue.Add(Neighbour);
+				}
+			}
+
+			for (const TPair<int32, int32>& Edge : Edges)
+			{
+				AddConnection(OutLayout, RoomOfNode[Edge.Key], RoomOfNode[Edge.Value]);
+			}
+
+			return true;
+		}
+
+	private:
+		// free cell closest to From, searched in growing rings; the direct neighbours are tried in random order
+		static bool FindFreeCell(const FRoomGrid& Grid, const TSet<FIntPoint>& Occupied, const FIntPoint& From, FRandomStream& RandomStream, FIntPoint& OutCell)
+		{
+			const int32 FirstDirection = RandomStream.RandRange(0, 3);
+			for (int32 Index = 0; Index < 4; Index++)
+			{
+				const FIntPoint Cell = From + GridDirections[(FirstDirection + Index) % 4];
+				if (Grid.Contains(Cell) && !Occupied.Contains(Cell))
+				{
+					OutCell = Cell;
+					return true;
+				}
+			}
+
+			const int32 MaxRadius = FMath::Max(Grid.Dimensions.X, Grid.Dimensions.Y);
+			for (int32 Radius = 2; Radius <= MaxRadius; Radius++)
+			{
+				for (int32 X = -Radius; X <= Radius; X++)
+				{
+					for (int32 Y = -Radius; Y <= Radius; Y++)
+					{
+						if (FMath::Abs(X) != Radius && FMath::Abs(Y) != Radius) continue;
+
+						const FIntPoint Cell = From + FIntPoint(X, Y);
+						if (Grid.Contains(Cell) && !Occupied.Contains(Cell))
+						{
+							OutCell = Cell;
+							return true;
+						}
+					}
+				}
+			}
+			return false;
+		}
+	};
+}
+
+FDungeonGeneratorRegistry& FDungeonGeneratorRegistry::Get()
+{
+	static FDungeonGeneratorRegistry Registry;
+	return Registry;
+}
+
+FDungeonGeneratorRegistry::FDungeonGeneratorRegistry()
+{
+	Register(MakeUnique<FRandomWalkGenerator>());
+	Register(MakeUnique<FBSPGenerator>());
+	Register(MakeUnique<FGraphGrammarGenerator>());
+}
+
+void FDungeonGeneratorRegistry::Register(TUniquePtr<IDungeonGenerator> Generator)
+{
+	check(Generator.IsValid());
+	const FName Name = Generator->GetName();
+	Generators.Add(Name, MoveTemp(Generator));
+}
+
+void FDungeonGeneratorRegistry::Unregister(FName Name)
+{
+	Generators.Remove(Name);
+}
+
+const IDungeonGenerator* FDungeonGeneratorRegistry::Find(FName Name) const
+{
+	const TUniquePtr<IDungeonGenerator>* Generator = Generators.Find(Name);
+	return Generator ? Generator->Get() : nullptr;
+}
+
+TArray<FName> FDungeonGeneratorRegistry::GetNames() const
+{
+	TArray<FName> Names;
+	Generators.GetKeys(Names);
+	return Names;
+}
+
+TSet<FWeightedWorld> FDungeonGeneratorRegistry::GetRoomPool(const UDataTable* LevelsDataTable)
+{
+	TSet<FWeightedWorld> Pool;
+	if (LevelsDataTable == nullptr || LevelsDataTable->RowStruct != FLevelsStruct::StaticStruct()) return Pool;
+
+	for (const TPair<FName, uint8*>& Row : LevelsDataTable->GetRowMap())
+	{
+		Pool.Append(reinterpret_cast<const FLevelsStruct*>(Row.Value)->ReplaceWorlds);
+	}
+	return Pool;
+}
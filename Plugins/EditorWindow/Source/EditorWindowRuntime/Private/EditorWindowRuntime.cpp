@@ -0,0 +1,12 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "EditorWindowRuntime.h"
+#include "Modules/ModuleManager.h"
+
+DEFINE_LOG_CATEGORY(LogDungeonGen);
+
+DEFINE_STAT(STAT_DungeonGen_LevelsLoaded);
+DEFINE_STAT(STAT_DungeonGen_ActorsSpawned);
+DEFINE_STAT(STAT_DungeonGen_GCsForced);
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, EditorWindowRuntime)
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GenerationManifest.h"
+#include "Engine/DataTable.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+void FGenerationManifest::SetLevel(const FManifestLevelEntry& Entry)
+{
+	for (FManifestLevelEntry& Level : Levels)
+	{
+		if (Level.LayoutLevel == Entry.LayoutLevel)
+		{
+			Level = Entry;
+			return;
+		}
+	}
+	Levels.Add(Entry);
+}
+
+void FGenerationManifest::SetActor(const FManifestActorEntry& Entry)
+{
+	for (FManifestActorEntry& Actor : Actors)
+	{
+		if (Actor.Level == Entry.Level && Actor.SourceActorName == Entry.SourceActorName)
+		{
+			Actor = Entry;
+			return;
+		}
+	}
+	Actors.Add(Entry);
+}
+
+void FGenerationManifest::RemoveActor(const FManifestLevelRef& Level, FName SourceActorName)
+{
+	Actors.RemoveAll([&Level, SourceActorName](const FManifestActorEntry& Actor) {
+		return Actor.Level == Level && Actor.SourceActorName == SourceActorName;
+	});
+}
+
+void FGenerationManifest::Reset()
+{
+	*this = FGenerationManifest();
+}
+
+bool FGenerationManifest::SaveToFile(const FString& FilePath)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes, true);
+	Writer << *this;
+
+	return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
+
+bool FGenerationManifest::LoadFromFile(const FString& FilePath)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath)) return false;
+
+	FGenerationManifest Loaded;
+	FMemoryReader Reader(Bytes, true);
+	Reader << Loaded;
+
+	if (Reader.IsError()) return false;
+
+	*this = MoveTemp(Loaded);
+	return true;
+}
+
+uint32 FGenerationManifest::HashDataTable(const UDataTable* DataTable)
+{
+	if (DataTable == nullptr || DataTable->RowStruct == nullptr) return 0;
+
+	// sort the rows by name so the hash doesn't depend on the order of the row map
+	TArray<FName> RowNames = DataTable->GetRowNames();
+	RowNames.Sort(FNameLexicalLess());
+
+	uint32 Hash = GetTypeHash(DataTable->RowStruct->GetFName());
+	for (const FName& RowName : RowNames)
+	{
+		const uint8* RowData = DataTable->GetRowMap()[RowName];
+
+		FString RowText;
+		DataTable->RowStruct->ExportText(RowText, RowData, nullptr, nullptr, PPF_None, nullptr);
+
+		Hash = FCrc::StrCrc32(*RowName.ToString(), Hash);
+		Hash = FCrc::StrCrc32(*RowText, Hash);
+	}
+
+	return Hash;
+}
+
+FArchive& operator<<(FArchive& Ar, FGenerationManifest& Manifest)
+{
+	uint32 Magic = FGenerationManifest::MagicNumber;
+	int32 Version = FGenerationManifest::CurrentVersion;
+
+	Ar << Magic << Version;
+
+	if (Ar.IsLoading() && (Magic != FGenerationManifest::MagicNumber || Version > FGenerationManifest::CurrentVersion))
+	{
+		Ar.SetError();
+		return Ar;
+	}
+
+	Ar << Manifest.LevelsSeed << Manifest.TagsSeed << Manifest.ActorsSeed;
+	Ar << Manifest.LevelsDataTableHash << Manifest.TagsDataTableHash << Manifest.ActorsDataTableHash;
+	Ar << Manifest.Levels << Manifest.Actors;
+
+	return Ar;
+}
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneratorSelection.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+
+FString GeneratorSelection::ClearPathFormatting(const FString& InputString)
+{
+	static const FString LevelInstancePostfix = TEXT("_LevelInstance_");
+	static const FString PIEPrefix = TEXT("UEDPIE_");
+
+	//remove level instancing postfix or object name, plain package names are kept as they are
+	int32 EndIndex = InputString.Find(LevelInstancePostfix, ESearchCase::CaseSensitive);
+	if (EndIndex == INDEX_NONE && !InputString.FindChar(TEXT('.'), EndIndex)) EndIndex = InputString.Len();
+
+	//remove PIE renaming (UEDPIE_<instance>_)
+	const int32 PIEIndex = InputString.Find(PIEPrefix, ESearchCase::CaseSensitive, ESearchDir::FromStart);
+	if (PIEIndex != INDEX_NONE && PIEIndex < EndIndex)
+	{
+		int32 PIEEndIndex = PIEIndex + PIEPrefix.Len();
+		while (PIEEndIndex < EndIndex && InputString[PIEEndIndex] != TEXT('_')) PIEEndIndex++;
+
+		return InputString.Left(PIEIndex) + InputString.Mid(PIEEndIndex + 1, EndIndex - PIEEndIndex - 1);
+	}
+
+	return InputString.Left(EndIndex);
+}
+
+FName GeneratorSelection::GetPackageKey(const FString& Path)
+{
+	return FName(ClearPathFormatting(Path));
+}
+
+FName GeneratorSelection::GetLevelPackageKey(const ULevelStreaming* LevelStream)
+{
+	if (LevelStream == nullptr) return NAME_None;
+
+	// level instances point to a unique package, PIE levels to a prefixed one; both normalize to the source world
+	return GetPackageKey(LevelStream->GetWorldAsset().ToSoftObjectPath().ToString());
+}
+
+FManifestLevelRef GeneratorSelection::MakeLevelRef(const UWorld* World, const ULevelStreaming* LevelStream)
+{
+	FManifestLevelRef LevelRef;
+	LevelRef.PackageKey = GetLevelPackageKey(LevelStream);
+
+	// count the levels with the same package that come before this one
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		if (StreamingLevel == LevelStream) break;
+		if (GetLevelPackageKey(StreamingLevel) == LevelRef.PackageKey) LevelRef.Ordinal++;
+	}
+
+	return LevelRef;
+}
+
+TMap<const ULevelStreaming*, FManifestLevelRef> GeneratorSelection::MakeLevelRefs(const UWorld* World)
+{
+	TMap<const ULevelStreaming*, FManifestLevelRef> LevelRefs;
+	TMap<FName, int32> Ordinals;
+
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		FManifestLevelRef& LevelRef = LevelRefs.Add(StreamingLevel);
+		LevelRef.PackageKey = GetLevelPackageKey(StreamingLevel);
+		LevelRef.Ordinal = Ordinals.FindOrAdd(LevelRef.PackageKey)++;
+	}
+
+	return LevelRefs;
+}
+
+FRandomStream GeneratorSelection::MakeLevelRandomStream(int32 Seed, const FManifestLevelRef& LevelRef)
+{
+	// hash the package string, FName hashes (and casing) aren't stable between sessions
+	uint32 Hash = HashCombine(uint32(Seed), FCrc::StrCrc32(*LevelRef.PackageKey.ToString().ToLower()));
+	Hash = HashCombine(Hash, uint32(LevelRef.Ordinal));
+	return FRandomStream(int32(Hash));
+}
+
+ULevelStreaming* GeneratorSelection::ResolveLevelRef(const UWorld* World, const FManifestLevelRef& LevelRef)
+{
+	int32 Ordinal = 0;
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		if (GetLevelPackageKey(StreamingLevel) != LevelRef.PackageKey) continue;
+		if (Ordinal++ == LevelRef.Ordinal) return StreamingLevel;
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelIdentityCache.h"
+#include "GeneratorSelection.h"
+#include "GeneratorTypes.h"
+#include "Engine/DataTable.h"
+#include "Engine/LevelStreaming.h"
+
+FLevelIdentityCache::~FLevelIdentityCache()
+{
+	if (UDataTable* OldDataTable = DataTable.Get()) OldDataTable->OnDataTableChanged().Remove(DataTableChangedHandle);
+}
+
+void FLevelIdentityCache::Update(UDataTable* LevelsDataTable)
+{
+	if (!bDirty && DataTable.Get() == LevelsDataTable) return;
+
+	if (DataTable.Get() != LevelsDataTable)
+	{
+		if (UDataTable* OldDataTable = DataTable.Get()) OldDataTable->OnDataTableChanged().Remove(DataTableChangedHandle);
+		DataTableChangedHandle.Reset();
+
+		DataTable = LevelsDataTable;
+		if (LevelsDataTable) DataTableChangedHandle = LevelsDataTable->OnDataTableChanged().AddRaw(this, &FLevelIdentityCache::Invalidate);
+	}
+
+	RowsByPackage.Reset();
+	bDirty = false;
+	if (LevelsDataTable == nullptr) return;
+
+	// only the soft path of the row world is needed, nothing gets loaded; first row wins for duplicate worlds
+	for (const TPair<FName, uint8*>& Row : LevelsDataTable->GetRowMap())
+	{
+		const FLevelsStruct* RowData = (const FLevelsStruct*)Row.Value;
+		const FName PackageKey = GeneratorSelection::GetPackageKey(RowData->World.ToSoftObjectPath().ToString());
+		if (PackageKey != NAME_None && !RowsByPackage.Contains(PackageKey)) RowsByPackage.Add(PackageKey, Row.Key);
+	}
+}
+
+void FLevelIdentityCache::Invalidate()
+{
+	bDirty = true;
+	StreamKeys.Reset();
+}
+
+FName FLevelIdentityCache::FindRow(FName PackageKey) const
+{
+	const FName* RowName = RowsByPackage.Find(PackageKey);
+	return RowName ? *RowName : NAME_None;
+}
+
+FName FLevelIdentityCache::FindRow(const ULevelStreaming* LevelStream)
+{
+	return FindRow(GetPackageKey(LevelStream));
+}
+
+FName FLevelIdentityCache::GetPackageKey(const ULevelStreaming* LevelStream)
+{
+	if (LevelStream == nullptr) return NAME_None;
+
+	if (const FName* PackageKey = StreamKeys.Find(LevelStream)) return *PackageKey;
+	return StreamKeys.Add(LevelStream, GeneratorSelection::GetLevelPackageKey(LevelStream));
+}
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class ULevel;
+
+// a single actor to spawn in a batch
+struct FActorSpawnRequest
+{
+	UClass* Class = nullptr;
+	FTransform Transform;
+
+	// level to spawn in, nullptr for the persistent level
+	ULevel* Level = nullptr;
+};
+
+// Spawns a batch of actors in two steps: every actor is created with deferred construction first, then all of them
+// run their construction scripts and finish spawning together, so the batch isn't interleaved with per-actor setup.
+class EDITORWINDOWRUNTIME_API FBulkActorSpawner
+{
+public:
+	// returns the spawned actors in request order, nullptr for requests that failed
+	static TArray<AActor*> SpawnActors(UWorld* World, TConstArrayView<FActorSpawnRequest> Requests);
+};
@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "GenerationManifest.h"
+#include "LevelIdentityCache.h"
+#include "DungeonGenerationSubsystem.generated.h"
+
+class UDataTable;
+class ULevelStreaming;
+struct FActorSpawnRequest;
+
+// input of a runtime generation run, same datatables the editor window uses
+USTRUCT(BlueprintType)
+struct FDungeonGenerationSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UDataTable* LevelsDataTable = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UDataTable* TagsDataTable = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UDataTable* ActorsDataTable = nullptr;
+
+	// seed of all three passes, 0 picks a random one
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Seed = 0;
+};
+
+// load time metrics of a generation run
+USTRUCT(BlueprintType)
+struct FDungeonGenerationStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	float SelectionSeconds = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float StreamingSeconds = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float SpawningSeconds = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float TotalSeconds = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 LevelsLoaded = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 ActorsSpawned = 0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnDungeonGenerated, const FDungeonGenerationStats&, Stats);
+
+// Runtime version of the editor generator: replaces the layout levels of a game world with level instances,
+// then replaces tagged/listed actors. Selection runs on a background thread and the rooms stream in
+// asynchronously, so the game can keep its loading screen up until OnDungeonGenerated fires.
+UCLASS()
+class EDITORWINDOWRUNTIME_API UDungeonGenerationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// start a generation run, returns false if one is already running
+	UFUNCTION(BlueprintCallable, Category="DungeonGeneration")
+	bool GenerateDungeon(const FDungeonGenerationSettings& Settings);
+
+	// re-create a recorded run without selecting again
+	bool GenerateFromManifest(const FGenerationManifest& InManifest);
+
+	UFUNCTION(BlueprintCallable, Category="DungeonGeneration")
+	bool GenerateFromManifestFile(const FString& FilePath);
+
+	// unload all generated rooms and destroy all spawned actors
+	UFUNCTION(BlueprintCallable, Category="DungeonGeneration")
+	void ClearDungeon();
+
+	UFUNCTION(BlueprintPure, Category="DungeonGeneration")
+	bool IsGenerating() const { return Phase != EPhase::Idle; }
+
+	const FGenerationManifest& GetManifest() const { return Manifest; }
+
+	// level and name of the actor a spawned replacement took the place of, stable across manifest re-creations
+	bool GetSpawnedActorSource(const AActor* SpawnedActor, FManifestLevelRef& OutLevel, FName& OutSourceActorName) const;
+
+	UPROPERTY(BlueprintAssignable, Category="DungeonGeneration")
+	FOnDungeonGenerated OnDungeonGenerated;
+
+	// UWorldSubsystem
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	enum class EPhase : uint8
+	{
+		Idle,
+		Selecting,
+		Streaming,
+		Spawning
+	};
+
+	// replacement world chosen for a layout level, filled on the background thread
+	struct FRoomChoice
+	{
+		int32 LayoutIndex = INDEX_NONE;
+		FManifestLevelRef LayoutRef;
+		TSoftObjectPtr<UWorld> World;
+	};
+
+	// called on the game thread when the background selection is done
+	void OnRoomsSelected(TArray<FRoomChoice> Choices);
+
+	// load a room and remember its layout level
+	ULevelStreaming* LoadRoom(const TSoftObjectPtr<UWorld>& World, const FTransform& Transform, ULevelStreaming* LayoutLevel);
+
+	// instance the sublevels of a room once it is loaded, returns true if it had any
+	bool LoadNestedLevels(ULevelStreaming* RoomStream);
+
+	// select and spawn the tags/actors replacements, on the loaded rooms
+	void GenerateActors();
+	void ApplyManifestActors();
+
+	// spawn the replacements in one batch, record them and remove the actors they replace
+	void SpawnReplacements(const TArray<AActor*>& SourceActors, const TArray<FActorSpawnRequest>& SpawnRequests);
+
+	void FinishGeneration();
+
+	EPhase Phase = EPhase::Idle;
+
+	// incremented on every run/clear, so late background results of an old run get dropped
+	uint32 RunId = 0;
+
+	FDungeonGenerationSettings CurrentSettings;
+	FGenerationManifest Manifest;
+
+	// row lookup of the levels datatable by level package
+	FLevelIdentityCache LevelIdentities;
+
+	// set when the run re-creates a manifest instead of selecting
+	bool bFromManifest = false;
+
+	// layout levels of the world, snapshot at the start of a run
+	UPROPERTY()
+	TArray<ULevelStreaming*> LayoutLevels;
+
+	// rooms still waiting for their sublevels to be instanced
+	UPROPERTY()
+	TArray<ULevelStreaming*> PendingRooms;
+
+	UPROPERTY()
+	TArray<ULevelStreaming*> GeneratedLevels;
+
+	UPROPERTY()
+	TArray<AActor*> SpawnedActors;
+
+	// source level and actor name of every spawned replacement
+	TMap<TObjectKey<AActor>, TPair<FManifestLevelRef, FName>> SpawnedActorSources;
+
+	FDungeonGenerationStats Stats;
+	double RunStartTime = 0.0;
+	double PhaseStartTime = 0.0;
+};
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GeneratorTypes.h"
+
+class UDataTable;
+
+// input of a native generator
+struct FDungeonGeneratorInput
+{
+	UDataTable* LevelsDataTable = nullptr;
+	UDataTable* TagsDataTable = nullptr;
+	UDataTable* ActorsDataTable = nullptr;
+
+	int32 Seed = 0;
+
+	// area the rooms are placed in, only X/Y are used, rooms are placed at Min.Z
+	FBox Bounds = FBox(FVector(-10000.f, -10000.f, 0.f), FVector(10000.f, 10000.f, 0.f));
+
+	// rooms are placed on the centers of a grid with this cell size
+	float CellSize = 2000.f;
+
+	int32 NumRooms = 10;
+};
+
+struct FDungeonLayoutRoom
+{
+	TSoftObjectPtr<UWorld> World;
+	FTransform Transform;
+};
+
+// output of a native generator
+struct FDungeonLayout
+{
+	TArray<FDungeonLayoutRoom> Rooms;
+
+	// pairs of connected room indices
+	TArray<TPair<int32, int32>> Connections;
+};
+
+// Layout algorithm compiled into the plugin. Called directly, without reflection, so it can be
+// used from the editor window, commandlets and the runtime alike.
+class EDITORWINDOWRUNTIME_API IDungeonGenerator
+{
+public:
+	virtual ~IDungeonGenerator() = default;
+
+	virtual FName GetName() const = 0;
+
+	// build a layout from the input, returns false if the input can't produce one
+	virtual bool Generate(const FDungeonGeneratorInput& Input, FDungeonLayout& OutLayout) const = 0;
+};
+
+// all native generators by name, the built-in ones (RandomWalk, BSP, GraphGrammar) are always registered
+class EDITORWINDOWRUNTIME_API FDungeonGeneratorRegistry
+{
+public:
+	static FDungeonGeneratorRegistry& Get();
+
+	// add a generator, replaces a registered generator of the same name
+	void Register(TUniquePtr<IDungeonGenerator> Generator);
+	void Unregister(FName Name);
+
+	const IDungeonGenerator* Find(FName Name) const;
+	TArray<FName> GetNames() const;
+
+	// worlds the generators pick rooms from: the replacement worlds of all rows of the levels datatable
+	static TSet<FWeightedWorld> GetRoomPool(const UDataTable* LevelsDataTable);
+
+private:
+	FDungeonGeneratorRegistry();
+
+	TMap<FName, TUniquePtr<IDungeonGenerator>> Generators;
+};
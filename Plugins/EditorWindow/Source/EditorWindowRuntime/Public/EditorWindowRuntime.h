@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogDungeonGen, Log, All);
+
+// "stat DungeonGen", shared by the editor and runtime generator
+DECLARE_STATS_GROUP(TEXT("DungeonGen"), STATGROUP_DungeonGen, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Levels Loaded"), STAT_DungeonGen_LevelsLoaded, STATGROUP_DungeonGen, EDITORWINDOWRUNTIME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Actors Spawned"), STAT_DungeonGen_ActorsSpawned, STATGROUP_DungeonGen, EDITORWINDOWRUNTIME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("GCs Forced"), STAT_DungeonGen_GCsForced, STATGROUP_DungeonGen, EDITORWINDOWRUNTIME_API);
+
+// cycle counter for "stat DungeonGen" plus a cpu trace scope of the same name for Unreal Insights
+#define DUNGEONGEN_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
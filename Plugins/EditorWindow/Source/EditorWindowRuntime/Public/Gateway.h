@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Gateway.generated.h"
+
+UCLASS(Blueprintable)
+class EDITORWINDOWRUNTIME_API AGateway : public AActor
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere)
+	bool EntryGateway;
+};
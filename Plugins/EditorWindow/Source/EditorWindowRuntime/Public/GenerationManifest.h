@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDataTable;
+
+// identifies a streamed level by its normalized package and which occurrence of that package it is in the world
+struct FManifestLevelRef
+{
+	// NAME_None stands for the persistent level
+	FName PackageKey;
+	int32 Ordinal = 0;
+
+	bool operator==(const FManifestLevelRef& Other) const
+	{
+		return PackageKey == Other.PackageKey && Ordinal == Other.Ordinal;
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FManifestLevelRef& Ref)
+	{
+		return Ar << Ref.PackageKey << Ref.Ordinal;
+	}
+};
+
+// replacement world chosen for a single layout level
+struct FManifestLevelEntry
+{
+	FManifestLevelRef LayoutLevel;
+	FString ReplaceWorldPath;
+	FString FolderName;
+	FTransform Transform;
+	FLinearColor Color;
+
+	friend FArchive& operator<<(FArchive& Ar, FManifestLevelEntry& Entry)
+	{
+		return Ar << Entry.LayoutLevel << Entry.ReplaceWorldPath << Entry.FolderName << Entry.Transform << Entry.Color;
+	}
+};
+
+// replacement actor spawned in place of a tagged/listed actor
+struct FManifestActorEntry
+{
+	FManifestLevelRef Level;
+	FName SourceActorName;
+	FString ReplaceActorClassPath;
+	FTransform Transform;
+
+	friend FArchive& operator<<(FArchive& Ar, FManifestActorEntry& Entry)
+	{
+		return Ar << Entry.Level << Entry.SourceActorName << Entry.ReplaceActorClassPath << Entry.Transform;
+	}
+};
+
+// Record of everything a generation run decided: seeds, datatable hashes and the chosen replacements.
+// Applying a manifest re-creates the generated result without running the selection again.
+class EDITORWINDOWRUNTIME_API FGenerationManifest
+{
+public:
+	static constexpr uint32 MagicNumber = 0x464D4744; // "DGMF"
+	static constexpr int32 CurrentVersion = 1;
+
+	int32 LevelsSeed = 0;
+	int32 TagsSeed = 0;
+	int32 ActorsSeed = 0;
+
+	uint32 LevelsDataTableHash = 0;
+	uint32 TagsDataTableHash = 0;
+	uint32 ActorsDataTableHash = 0;
+
+	TArray<FManifestLevelEntry> Levels;
+	TArray<FManifestActorEntry> Actors;
+
+	// add the level entry, replacing an existing one for the same layout level
+	void SetLevel(const FManifestLevelEntry& Entry);
+
+	// add the actor entry, replacing an existing one for the same source actor
+	void SetActor(const FManifestActorEntry& Entry);
+	void RemoveActor(const FManifestLevelRef& Level, FName SourceActorName);
+
+	void Reset();
+
+	bool SaveToFile(const FString& FilePath);
+	bool LoadFromFile(const FString& FilePath);
+
+	// hash of the datatable rows' content, independent of the row map iteration order
+	static uint32 HashDataTable(const UDataTable* DataTable);
+
+	friend FArchive& operator<<(FArchive& Ar, FGenerationManifest& Manifest);
+};
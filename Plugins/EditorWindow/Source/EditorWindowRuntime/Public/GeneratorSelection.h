@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenerationManifest.h"
+
+class ULevelStreaming;
+
+// helpers shared by the editor and the runtime generator, so both make the same choices for the same seed
+namespace GeneratorSelection
+{
+	// clear all engine formatting (level instance postfix, object name, PIE prefix) of a level path
+	EDITORWINDOWRUNTIME_API FString ClearPathFormatting(const FString& InputString);
+
+	// normalized package name of a level/world path, used as the identity of a level
+	EDITORWINDOWRUNTIME_API FName GetPackageKey(const FString& Path);
+
+	// normalized package name of the world a streaming level points to
+	EDITORWINDOWRUNTIME_API FName GetLevelPackageKey(const ULevelStreaming* LevelStream);
+
+	// reference of a streamed level: its package key and which occurrence of that key it is in the world
+	EDITORWINDOWRUNTIME_API FManifestLevelRef MakeLevelRef(const UWorld* World, const ULevelStreaming* LevelStream);
+
+	// references of all streamed levels of a world, in a single pass
+	EDITORWINDOWRUNTIME_API TMap<const ULevelStreaming*, FManifestLevelRef> MakeLevelRefs(const UWorld* World);
+
+	// random stream of a single layout level, derived from the run seed and the level reference; every level
+	// gets its own stream, so its choice doesn't depend on the order (or thread) the levels are selected in
+	EDITORWINDOWRUNTIME_API FRandomStream MakeLevelRandomStream(int32 Seed, const FManifestLevelRef& LevelRef);
+
+	// find the streamed level a manifest reference points to, nullptr if there's none
+	EDITORWINDOWRUNTIME_API ULevelStreaming* ResolveLevelRef(const UWorld* World, const FManifestLevelRef& LevelRef);
+
+	// sum of all weights of a weighted set (FWeightedWorld/FWeightedActor)
+	template<typename WeightedType>
+	int32 SumOfWeights(const TSet<WeightedType>& WeightedSet)
+	{
+		int32 Sum = 0;
+		for (const WeightedType& Weighted : WeightedSet)
+		{
+			Sum += Weighted.Weight;
+		}
+		return Sum;
+	}
+
+	// move a uniformly random subset of NumToSelect elements to the front of the array (partial Fisher-Yates),
+	// in place and in O(NumToSelect); returns the number of selected elements
+	template<typename ElementType, typename AllocatorType>
+	int32 SelectRandomSubset(TArray<ElementType, AllocatorType>& Elements, int32 NumToSelect, FRandomStream& RandomStream)
+	{
+		NumToSelect = FMath::Clamp(NumToSelect, 0, Elements.Num());
+		for (int32 Index = 0; Index < NumToSelect; Index++)
+		{
+			Elements.Swap(Index, RandomStream.RandRange(Index, Elements.Num() - 1));
+		}
+		return NumToSelect;
+	}
+
+	// return a random element of a weighted set using the given random stream, nullptr if all weights are zero
+	template<typename WeightedType>
+	const WeightedType* WeightedRandom(const TSet<WeightedType>& WeightedSet, FRandomStream& RandomStream, int32 SumOfWeights)
+	{
+		if (SumOfWeights <= 0) return nullptr;
+
+		int32 RandomNumber = RandomStream.RandRange(0, SumOfWeights - 1);
+		for (const WeightedType& Weighted : WeightedSet)
+		{
+			if (RandomNumber < Weighted.Weight) return &Weighted;
+			RandomNumber -= Weighted.Weight;
+		}
+		return nullptr;
+	}
+}
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "GeneratorTypes.generated.h"
+
+
+// Helper structs (TPair cant work on UPROPERTY)
+USTRUCT(BlueprintType)
+struct FWeightedWorld
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TSoftObjectPtr<UWorld> World;
+
+	UPROPERTY(EditAnywhere)
+	uint16 Weight;
+};
+
+USTRUCT(BlueprintType)
+struct FWeightedActor
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TSubclassOf<AActor> Actor;
+
+	UPROPERTY(EditAnywhere)
+	uint16 Weight;
+};
+
+// hash function for the helper stucts, used when they get put in a set
+// (hash the referenced asset path, not the struct memory, so the hash is stable between runs)
+inline uint32 GetTypeHash(const FWeightedWorld& World)
+{
+	return HashCombine(GetTypeHash(World.World.ToSoftObjectPath()), GetTypeHash(World.Weight));
+}
+
+inline uint32 GetTypeHash(const FWeightedActor& Actor)
+{
+	return HashCombine(GetTypeHash(FSoftObjectPath(Actor.Actor.Get())), GetTypeHash(Actor.Weight));
+}
+
+inline bool operator==(const FWeightedWorld& A, const FWeightedWorld& B)
+{
+	return A.World == B.World && A.Weight == B.Weight;
+}
+
+inline bool operator==(const FWeightedActor& A, const FWeightedActor& B)
+{
+	return A.Actor == B.Actor && A.Weight == B.Weight;
+}
+
+
+// Structs to use for the levels datatables
+USTRUCT(BlueprintType)
+struct FLevelsStruct : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TSoftObjectPtr<UWorld> World;
+
+	UPROPERTY(EditAnywhere)
+	TSet<FWeightedWorld> ReplaceWorlds;
+};
+
+USTRUCT(BlueprintType)
+struct FTagsStruct : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	FName ActorTag;
+
+	UPROPERTY(EditAnywhere)
+	uint8 NumberOfElements;
+
+	UPROPERTY(EditAnywhere)
+	TSubclassOf<AActor> ReplaceActor;
+};
+
+USTRUCT(BlueprintType)
+struct FActorsStruct : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TSubclassOf<AActor> Actor;
+
+	UPROPERTY(EditAnywhere)
+	TSet<FWeightedActor> ReplaceActors;
+};
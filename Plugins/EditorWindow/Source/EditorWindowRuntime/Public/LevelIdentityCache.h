@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UDataTable;
+class ULevelStreaming;
+
+// Caches the normalized package key of every levels datatable row and streaming level, so finding the row a
+// level belongs to is a hash lookup instead of normalizing (and loading) every row's world per level.
+class EDITORWINDOWRUNTIME_API FLevelIdentityCache
+{
+public:
+	FLevelIdentityCache() = default;
+	~FLevelIdentityCache();
+	UE_NONCOPYABLE(FLevelIdentityCache);
+
+	// (re)build the row lookup if the datatable changed since the last call
+	void Update(UDataTable* LevelsDataTable);
+
+	// drop all cached keys, the next Update rebuilds
+	void Invalidate();
+
+	// name of the row whose world has the given package key, NAME_None if there's none
+	FName FindRow(FName PackageKey) const;
+	FName FindRow(const ULevelStreaming* LevelStream);
+
+	// package key of a streaming level, computed once per stream
+	FName GetPackageKey(const ULevelStreaming* LevelStream);
+
+private:
+	TWeakObjectPtr<UDataTable> DataTable;
+	FDelegateHandle DataTableChangedHandle;
+	bool bDirty = true;
+
+	TMap<FName, FName> RowsByPackage;
+	TMap<TObjectKey<ULevelStreaming>, FName> StreamKeys;
+};
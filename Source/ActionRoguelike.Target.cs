@@ -11,5 +11,9 @@ public class ActionRoguelikeTarget : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_1;
 		ExtraModuleNames.Add("ActionRoguelike");
+
+		// push model replication is compiled out unless the target enables it, which needs its own engine build
+		bWithPushModel = true;
+		BuildEnvironment = TargetBuildEnvironment.Unique;
 	}
 }
@@ -3,4 +3,10 @@
 #include "ActionRoguelike.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogActionRoguelike);
+
+DEFINE_STAT(STAT_ActionRoguelike_ReplicatedProjectiles);
+DEFINE_STAT(STAT_ActionRoguelike_PredictedProjectiles);
+DEFINE_STAT(STAT_ActionRoguelike_RejectedProjectiles);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ActionRoguelike, "ActionRoguelike" );
@@ -3,4 +3,13 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogActionRoguelike, Log, All);
+
+// "stat ActionRoguelike", gameplay counters next to "stat net" when profiling a multi-process PIE session
+DECLARE_STATS_GROUP(TEXT("ActionRoguelike"), STATGROUP_ActionRoguelike, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Replicated Projectiles"), STAT_ActionRoguelike_ReplicatedProjectiles, STATGROUP_ActionRoguelike, ACTIONROGUELIKE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Predicted Projectiles"), STAT_ActionRoguelike_PredictedProjectiles, STATGROUP_ActionRoguelike, ACTIONROGUELIKE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Rejected Projectiles"), STAT_ActionRoguelike_RejectedProjectiles, STATGROUP_ActionRoguelike, ACTIONROGUELIKE_API);
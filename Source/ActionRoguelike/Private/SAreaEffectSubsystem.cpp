@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SAreaEffectSubsystem.h"
+#include "ActionRoguelike.h"
+#include "SAttributeComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("AreaEffect Apply"), STAT_AreaEffectApply, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AreaEffect Overlap Queries"), STAT_AreaEffectOverlaps, STATGROUP_ActionRoguelike);
+DECLARE_CYCLE_STAT(TEXT("AreaEffect RadialForce"), STAT_AreaEffectRadialForce, STATGROUP_ActionRoguelike);
+
+bool USAreaEffectSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 USAreaEffectSubsystem::ApplyAreaEffect(const FSAreaEffect& Effect)
+{
+	return ApplyAreaEffects(MakeArrayView(&Effect, 1), Effect.Location, Effect.Radius);
+}
+
+int32 USAreaEffectSubsystem::ApplyAreaEffects(TConstArrayView<FSAreaEffect> Effects, const FVector& Center, float Radius)
+{
+	if (Effects.Num() == 0 || Radius <= 0.0f) return 0;
+
+	SCOPE_CYCLE_COUNTER(STAT_AreaEffectApply);
+
+	TArray<FOverlapResult> Overlaps;
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(AreaEffectOverlap), false);
+	GetWorld()->OverlapMultiByObjectType(Overlaps, Center, FQuat::Identity,
+		FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllDynamicObjects),
+		FCollisionShape::MakeSphere(Radius), Params);
+	INC_DWORD_STAT(STAT_AreaEffectOverlaps);
+
+	// an actor shows up once per overlapping component, it is damaged once and each body is pushed once
+	TSet<const UObject*, DefaultKeyFuncs<const UObject*>, TInlineSetAllocator<64>> Affected;
+	for (const FOverlapResult& Overlap : Overlaps) {
+		UPrimitiveComponent* Primitive = Overlap.GetComponent();
+		AActor* Actor = Overlap.GetActor();
+
+		bool bAlreadyAffected = false;
+		if (Primitive && Primitive->IsSimulatingPhysics()) {
+			Affected.Add(Primitive, &bAlreadyAffected);
+			if (!bAlreadyAffected) {
+				// bodies outside an effect's radius are skipped by AddRadialImpulse
+				for (const FSAreaEffect& Effect : Effects) {
+					if (Effect.ImpulseStrength != 0.0f) {
+						Primitive->AddRadialImpulse(Effect.Location, Effect.Radius, Effect.ImpulseStrength, Effect.Falloff, Effect.bVelChange);
+					}
+				}
+			}
+		}
+
+		if (Actor == nullptr) continue;
+		Affected.Add(Actor, &bAlreadyAffected);
+		if (bAlreadyAffected) continue;
+
+		USAttributeComponent* AttributeComp = nullptr;
+		for (const FSAreaEffect& Effect : Effects) {
+			if (Effect.Damage <= 0.0f || Effect.IgnoredActor == Actor) continue;
+
+			const float Distance = FVector::Dist(Effect.Location, Actor->GetActorLocation());
+			if (Distance > Effect.Radius) continue;
+
+			AttributeComp = AttributeComp ? AttributeComp : USAttributeComponent::GetAttributes(Actor);
+			if (AttributeComp == nullptr) break;
+
+			const float Scale = Effect.Falloff == RIF_Linear ? 1.0f - Distance / Effect.Radius : 1.0f;
+			AttributeComp->ApplyHealthChange(-Effect.Damage * Scale);
+		}
+	}
+
+	return Affected.Num();
+}
+
+int32 USAreaEffectSubsystem::ApplyRadialForce(TConstArrayView<UPrimitiveComponent*> Bodies, const FVector& Origin, float Radius, float Strength, ERadialImpulseFalloff Falloff, bool bAccelChange)
+{
+	if (Bodies.Num() == 0 || Radius <= 0.0f) return 0;
+
+	SCOPE_CYCLE_COUNTER(STAT_AreaEffectRadialForce);
+
+	int32 NumPushed = 0;
+	for (UPrimitiveComponent* Body : Bodies) {
+		if (Body == nullptr || !Body->IsSimulatingPhysics()) continue;
+
+		// bodies outside the radius are skipped by AddRadialForce
+		Body->AddRadialForce(Origin, Radius, Strength, Falloff, bAccelChange);
+		NumPushed++;
+	}
+	return NumPushed;
+}
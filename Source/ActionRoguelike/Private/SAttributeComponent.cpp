@@ -2,12 +2,84 @@
 
 
 #include "SAttributeComponent.h"
+#include "ActionRoguelike.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "UObject/ObjectKey.h"
+
+// attribute component of each actor that has one, registered components only. game thread only
+static TMap<TObjectKey<AActor>, USAttributeComponent*> AttributeRegistry;
+
+// replicated health steps per point
+static const float HealthQuantization = 10.0f;
+
+static uint32 QuantizeHealth(float Value)
+{
+	// never round a living actor down to zero, clients use the replicated value for IsAlive
+	const uint32 Quantized = (uint32)FMath::RoundToInt(FMath::Max(Value, 0.0f) * HealthQuantization);
+	return Quantized == 0 && Value > 0.0f ? 1 : Quantized;
+}
+
+bool FSQuantizedHealth::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 QuantizedHealth = Ar.IsSaving() ? QuantizeHealth(Health) : 0;
+	uint32 QuantizedMaxHealth = Ar.IsSaving() ? QuantizeHealth(MaxHealth) : 0;
+
+	Ar.SerializeIntPacked(QuantizedHealth);
+	Ar.SerializeIntPacked(QuantizedMaxHealth);
+
+	if (Ar.IsLoading()) {
+		Health = QuantizedHealth / HealthQuantization;
+		MaxHealth = QuantizedMaxHealth / HealthQuantization;
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
 
 // Sets default values for this component's properties
 USAttributeComponent::USAttributeComponent()
 {
 	MaxHealth = 100.0f;
 	Health = MaxHealth;
+
+	SetIsReplicatedByDefault(true);
+}
+
+void USAttributeComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// start from the blueprint defaults on both sides, so clients don't get a change event for the initial state
+	ReplicatedHealth.Health = Health;
+	ReplicatedHealth.MaxHealth = MaxHealth;
+}
+
+USAttributeComponent* USAttributeComponent::GetAttributes(const AActor* Actor)
+{
+	USAttributeComponent* const* AttributeComp = Actor ? AttributeRegistry.Find(Actor) : nullptr;
+	return AttributeComp ? *AttributeComp : nullptr;
+}
+
+void USAttributeComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (GetOwner()) {
+		AttributeRegistry.FindOrAdd(GetOwner(), this);
+	}
+}
+
+void USAttributeComponent::OnUnregister()
+{
+	// registered components are unregistered before they are destroyed, so the registry never holds a dead one
+	USAttributeComponent* const* Registered = GetOwner() ? AttributeRegistry.Find(GetOwner()) : nullptr;
+	if (Registered && *Registered == this) {
+		AttributeRegistry.Remove(GetOwner());
+	}
+
+	Super::OnUnregister();
 }
 
 bool USAttributeComponent::IsAlive() const{
@@ -16,9 +88,20 @@ bool USAttributeComponent::IsAlive() const{
 
 bool USAttributeComponent::ApplyHealthChange(float Delta)
 {
+	// health is server authoritative, clients get the change through OnRep_Health
+	if (!GetOwner()->HasAuthority()) {
+		return false;
+	}
+
+	const float OldHealth = Health;
 	Health += Delta;
 	Health = FMath::Clamp(Health, 0.0f, MaxHealth);
 
+	if (Health != OldHealth) {
+		ReplicatedHealth.Health = Health;
+		MARK_PROPERTY_DIRTY_FROM_NAME(USAttributeComponent, ReplicatedHealth, this);
+	}
+
 	OnHealthChanged.Broadcast(nullptr, this, Health, Delta);
 
 	return true;
@@ -28,3 +111,34 @@ bool USAttributeComponent::IsMaxHealth()
 {
 	return Health == MaxHealth;
 }
+
+void USAttributeComponent::OnRep_Health(const FSQuantizedHealth& OldHealth)
+{
+	Health = ReplicatedHealth.Health;
+	MaxHealth = ReplicatedHealth.MaxHealth;
+
+	OnHealthChanged.Broadcast(nullptr, this, Health, Health - OldHealth.Health);
+}
+
+void USAttributeComponent::SerializeSaveState(FArchive& Ar, int32 Version)
+{
+	const float OldHealth = Health;
+	Ar << Health << MaxHealth;
+
+	if (Ar.IsLoading()) {
+		ReplicatedHealth.Health = Health;
+		ReplicatedHealth.MaxHealth = MaxHealth;
+		MARK_PROPERTY_DIRTY_FROM_NAME(USAttributeComponent, ReplicatedHealth, this);
+
+		OnHealthChanged.Broadcast(nullptr, this, Health, Health - OldHealth);
+	}
+}
+
+void USAttributeComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(USAttributeComponent, ReplicatedHealth, Params);
+}
@@ -0,0 +1,404 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActionRoguelike.h"
+#include "SAreaEffectSubsystem.h"
+#include "SAttributeComponent.h"
+#include "SExplosionSubsystem.h"
+#include "SExplosiveBarrel.h"
+#include "SGameplayInterface.h"
+#include "SItemChest.h"
+#include "SLagCompensationSubsystem.h"
+#include "SSaveGameSubsystem.h"
+#include "STargetDummy.h"
+#include "Containers/Ticker.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "PhysicsEngine/RadialForceComponent.h"
+#include "Serialization/BitWriter.h"
+
+// benchmark console commands of the game systems, none of them ship
+
+#if !UE_BUILD_SHIPPING
+
+// ActionRoguelike.HealthNetBenchmark [Actors] [ChangedPercent] [Frames]: serialization cost of the quantized health,
+// then on a server spawns Actors replicated attribute components, changes ChangedPercent of them every frame and
+// logs the bytes sent and the frame time per 1000 actors. Run it in a game target build (the editor target has no
+// push model) with net.IsPushModelEnabled 0 and 1 to compare, "stat net" shows the replicate actors time.
+static FAutoConsoleCommandWithWorldAndArgs HealthNetBenchmarkCommand(
+	TEXT("ActionRoguelike.HealthNetBenchmark"),
+	TEXT("Measure bytes and server cpu of replicated health for Actors (default 1000) actors, ChangedPercent (default 5) of them changing every frame, over Frames (default 300) frames."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr) return;
+
+		const int32 NumActors = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000;
+		const float ChangedPercent = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 5.0f;
+		const int32 NumFrames = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 300;
+		if (NumActors <= 0 || NumFrames <= 0) return;
+
+		// encoding: quantized struct against the two raw floats it replaces
+		FRandomStream Random(NumActors);
+		TArray<FSQuantizedHealth> Values;
+		Values.SetNum(NumActors);
+		for (FSQuantizedHealth& Value : Values) {
+			Value.MaxHealth = 100.0f;
+			Value.Health = Random.FRandRange(0.0f, Value.MaxHealth);
+		}
+
+		FBitWriter QuantizedWriter(0, true);
+		double StartTime = FPlatformTime::Seconds();
+		for (FSQuantizedHealth& Value : Values) {
+			bool bSuccess = false;
+			Value.NetSerialize(QuantizedWriter, nullptr, bSuccess);
+		}
+		const double QuantizedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		FBitWriter FloatWriter(0, true);
+		for (FSQuantizedHealth& Value : Values) {
+			FloatWriter << Value.Health << Value.MaxHealth;
+		}
+
+		const double Per1000 = 1000.0 / NumActors;
+		UE_LOG(LogActionRoguelike, Display, TEXT("Health encoding per 1000 actors: quantized %.0f bytes in %.3f ms, floats %.0f bytes"),
+			QuantizedWriter.GetNumBytes() * Per1000, QuantizedSeconds * 1000.0 * Per1000, FloatWriter.GetNumBytes() * Per1000);
+
+		UNetDriver* NetDriver = World->GetNetDriver();
+		if (NetDriver == nullptr || !NetDriver->IsServer()) {
+			UE_LOG(LogActionRoguelike, Display, TEXT("Health replication benchmark needs a server world, only the encoding was measured"));
+			return;
+		}
+
+		TArray<TWeakObjectPtr<USAttributeComponent>> Components;
+		TArray<TWeakObjectPtr<AActor>> Actors;
+		for (int32 Index = 0; Index < NumActors; Index++) {
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+			if (Actor == nullptr) continue;
+
+			Actor->bAlwaysRelevant = true;
+			Actor->SetReplicates(true);
+
+			USAttributeComponent* Component = NewObject<USAttributeComponent>(Actor);
+			Actor->AddInstanceComponent(Component);
+			Component->RegisterComponent();
+
+			Actors.Add(Actor);
+			Components.Add(Component);
+		}
+		if (Components.Num() == 0) return;
+
+		const int32 NumChanged = FMath::Clamp(FMath::RoundToInt(NumActors * ChangedPercent / 100.0f), 0, Components.Num());
+		TSharedRef<int32> Frame = MakeShared<int32>(0);
+		TSharedRef<uint32> StartBytes = MakeShared<uint32>(0);
+		TSharedRef<double> ChangeSeconds = MakeShared<double>(0.0);
+		TSharedRef<double> FrameSeconds = MakeShared<double>(0.0);
+		TWeakObjectPtr<UNetDriver> WeakNetDriver = NetDriver;
+
+		// the first frames send the initial state of the new actors, that is not what we measure
+		const int32 WarmupFrames = 2;
+
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([=](float DeltaTime)
+		{
+			UNetDriver* Driver = WeakNetDriver.Get();
+			if (Driver == nullptr) return false;
+
+			const int32 CurrentFrame = (*Frame)++;
+			if (CurrentFrame < WarmupFrames) return true;
+			if (CurrentFrame == WarmupFrames) {
+				*StartBytes = Driver->OutTotalBytes;
+			}
+			else {
+				*FrameSeconds += DeltaTime;
+			}
+
+			if (CurrentFrame < WarmupFrames + NumFrames) {
+				const double ChangeStart = FPlatformTime::Seconds();
+				for (int32 Index = 0; Index < NumChanged; Index++) {
+					USAttributeComponent* Component = Components[(CurrentFrame * NumChanged + Index) % Components.Num()].Get();
+					if (Component) {
+						Component->ApplyHealthChange(Component->IsMaxHealth() ? -1.0f : 1.0f);
+					}
+				}
+				*ChangeSeconds += FPlatformTime::Seconds() - ChangeStart;
+				return true;
+			}
+
+			const double Per1000Actors = 1000.0 / Components.Num();
+			const double Seconds = FMath::Max(*FrameSeconds, UE_SMALL_NUMBER);
+			UE_LOG(LogActionRoguelike, Display, TEXT("Health replication of %d actors (%d changed/frame, push model %s): %.0f bytes/s sent per 1000 actors, %.3f ms/frame, %.4f ms/frame in ApplyHealthChange"),
+				Components.Num(), NumChanged, IS_PUSH_MODEL_ENABLED() ? TEXT("on") : TEXT("off"),
+				(Driver->OutTotalBytes - *StartBytes) / Seconds * Per1000Actors,
+				Seconds * 1000.0 / NumFrames,
+				*ChangeSeconds * 1000.0 / NumFrames);
+
+			for (const TWeakObjectPtr<AActor>& Actor : Actors) {
+				if (Actor.IsValid()) {
+					Actor->Destroy();
+				}
+			}
+			return false;
+		}));
+	}));
+
+// ActionRoguelike.RewindBenchmark [Pawns] [Validations]: fill a full history for Pawns pawns, then rewind and
+// check Validations hits against random pawns at random times, log the record and rewind cost
+static FAutoConsoleCommand RewindBenchmarkCommand(
+	TEXT("ActionRoguelike.RewindBenchmark"),
+	TEXT("Measure the cost of recording Pawns (default 100) hitbox histories and of Validations (default 100000) rewound hit checks."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumPawns = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100;
+		const int32 NumValidations = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 100000;
+		if (NumPawns <= 0 || NumValidations <= 0) return;
+
+		const int32 Capacity = USLagCompensationSubsystem::HistoryCapacity;
+		const double FrameTime = USLagCompensationSubsystem::RecordInterval;
+		FRandomStream Random(NumPawns);
+
+		TArray<FSHitboxHistory> Histories;
+		Histories.Init(FSHitboxHistory(Capacity), NumPawns);
+
+		// one sample per pawn per interval, twice the capacity so the ring has wrapped
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < Capacity * 2; Frame++) {
+			for (FSHitboxHistory& History : Histories) {
+				History.Record(Frame * FrameTime, Random.GetUnitVector() * 1000.0f);
+			}
+		}
+		const double RecordSeconds = FPlatformTime::Seconds() - StartTime;
+
+		const double NewestTime = (Capacity * 2 - 1) * FrameTime;
+		int32 NumHits = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumValidations; Index++) {
+			const FSHitboxHistory& History = Histories[Random.RandHelper(NumPawns)];
+			FVector Location;
+			if (History.Rewind(NewestTime - Random.FRand() * USLagCompensationSubsystem::MaxRewindSeconds, Location)) {
+				NumHits += USLagCompensationSubsystem::DistanceToCapsule(Random.GetUnitVector() * 1000.0f, Location, 34.0f, 88.0f) <= 50.0f;
+			}
+		}
+		const double RewindSeconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogActionRoguelike, Display, TEXT("Rewind benchmark: %d pawns x %d samples (%d bytes per pawn), record %.3f us per pawn frame, validate %.3f us per hit (%d/%d hits)"),
+			NumPawns, Capacity, (int32)(Capacity * sizeof(FSHitboxSample)),
+			RecordSeconds * 1e6 / (NumPawns * Capacity * 2),
+			RewindSeconds * 1e6 / NumValidations, NumHits, NumValidations);
+	}));
+
+// ActionRoguelike.SaveBenchmark [Actors]: spawn Actors savable target dummies, then time capture, write, read and
+// a restore that re-spawns all of them deferred
+static FAutoConsoleCommandWithWorldAndArgs SaveBenchmarkCommand(
+	TEXT("ActionRoguelike.SaveBenchmark"),
+	TEXT("Measure save and load time of Actors (default 10000) spawned savable actors."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		USSaveGameSubsystem* SaveGame = World ? World->GetSubsystem<USSaveGameSubsystem>() : nullptr;
+		if (SaveGame == nullptr || SaveGame->IsBusy()) return;
+
+		const int32 NumActors = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+		if (NumActors <= 0) return;
+
+		TSet<ASTargetDummy*> ExistingDummies;
+		for (TActorIterator<ASTargetDummy> It(World); It; ++It) {
+			ExistingDummies.Add(*It);
+		}
+
+		for (int32 Index = 0; Index < NumActors; Index++) {
+			const FTransform Transform(FVector(Index % 100, Index / 100, 0) * 100.0);
+			World->SpawnActor<ASTargetDummy>(ASTargetDummy::StaticClass(), Transform);
+		}
+
+		double StartTime = FPlatformTime::Seconds();
+		FSSaveSnapshot Snapshot;
+		SaveGame->CaptureSnapshot(Snapshot);
+		const double CaptureSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		TArray<uint8> Bytes;
+		const FString FilePath = USSaveGameSubsystem::GetSlotPath(TEXT("Benchmark"));
+		USSaveGameSubsystem::WriteSnapshot(Snapshot, Bytes);
+		FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+		const double WriteSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		TArray<uint8> ReadBytes;
+		FSSaveSnapshot ReadBack;
+		FFileHelper::LoadFileToArray(ReadBytes, *FilePath);
+		USSaveGameSubsystem::ReadSnapshot(ReadBytes, ReadBack);
+		const double ReadSeconds = FPlatformTime::Seconds() - StartTime;
+
+		// the spawned dummies are destroyed and re-spawned from the snapshot
+		StartTime = FPlatformTime::Seconds();
+		const int32 NumRestored = SaveGame->RestoreActors(ReadBack);
+		const double RestoreSeconds = FPlatformTime::Seconds() - StartTime;
+
+		for (TActorIterator<ASTargetDummy> It(World); It; ++It) {
+			if (!ExistingDummies.Contains(*It)) It->Destroy();
+		}
+
+		UE_LOG(LogActionRoguelike, Display, TEXT("Save benchmark (%d actors, %d saved, %d bytes): capture %.2f ms (game thread), compress and write %.2f ms, read and inflate %.2f ms, restore %d actors %.2f ms"),
+			NumActors, Snapshot.Actors.Num(), Bytes.Num(), CaptureSeconds * 1000.0, WriteSeconds * 1000.0,
+			ReadSeconds * 1000.0, NumRestored, RestoreSeconds * 1000.0);
+	}));
+
+// ActionRoguelike.BarrelStress [Count] [Class]: spawn Count barrels in stacked rows in front of the first player and
+// set off the one in the middle, watch the chain with stat ActionRoguelike
+static FAutoConsoleCommandWithWorldAndArgs BarrelStressCommand(
+	TEXT("ActionRoguelike.BarrelStress"),
+	TEXT("Spawn Count (default 500) barrels of Class (default BarrelBP) in front of the player and set off a chain reaction."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		USExplosionSubsystem* Explosions = World ? World->GetSubsystem<USExplosionSubsystem>() : nullptr;
+		APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+		if (Explosions == nullptr || PlayerController == nullptr || PlayerController->GetPawn() == nullptr) return;
+
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 500;
+		UClass* BarrelClass = LoadClass<ASExplosiveBarrel>(nullptr, Args.Num() > 1 ? *Args[1] : TEXT("/Game/ActionRoguelike/BarrelBP.BarrelBP_C"));
+		if (Count <= 0 || BarrelClass == nullptr) return;
+
+		// 10 x 10 barrels per layer, layers stacked on top of each other
+		const APawn* Pawn = PlayerController->GetPawn();
+		const FVector Origin = Pawn->GetActorLocation() + Pawn->GetActorForwardVector() * 1500.0f;
+		const FVector Spacing(120.0f, 120.0f, 180.0f);
+
+		TArray<ASExplosiveBarrel*> Barrels;
+		Barrels.Reserve(Count);
+		for (int32 Index = 0; Index < Count; Index++) {
+			const FVector Offset((Index % 10 - 4.5f) * Spacing.X, (Index / 10 % 10 - 4.5f) * Spacing.Y, Index / 100 * Spacing.Z);
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			Barrels.Add(World->SpawnActor<ASExplosiveBarrel>(BarrelClass, FTransform(Origin + Offset), SpawnParams));
+		}
+
+		if (ASExplosiveBarrel* Barrel = Barrels[Barrels.Num() / 2]) {
+			Barrel->Detonate(nullptr);
+		}
+		UE_LOG(LogActionRoguelike, Display, TEXT("Barrel stress: spawned %d barrels, %d explosions queued"), Barrels.Num(), Explosions->GetNumQueued());
+	}));
+
+// ActionRoguelike.AreaEffectBenchmark [Actors] [Effects]: spawn Actors physics props and target dummies in front of the
+// player, then apply Effects explosions among them the old way, with a radial force component and a damage overlap
+// that looks up attributes per actor, and through the area effect subsystem
+static FAutoConsoleCommandWithWorldAndArgs AreaEffectBenchmarkCommand(
+	TEXT("ActionRoguelike.AreaEffectBenchmark"),
+	TEXT("Compare Effects (default 1000) area effects among Actors (default 200) actors through radial force components and through the area effect subsystem."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		USAreaEffectSubsystem* AreaEffects = World ? World->GetSubsystem<USAreaEffectSubsystem>() : nullptr;
+		APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+		if (AreaEffects == nullptr || PlayerController == nullptr || PlayerController->GetPawn() == nullptr) return;
+
+		const int32 NumActors = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 200;
+		const int32 NumEffects = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000;
+		UClass* PropClass = LoadClass<AActor>(nullptr, TEXT("/Game/ActionRoguelike/BarrelBP.BarrelBP_C"));
+		UClass* DummyClass = LoadClass<AActor>(nullptr, TEXT("/Game/ActionRoguelike/TargetDummyBP.TargetDummyBP_C"));
+		if (NumActors <= 0 || NumEffects <= 0 || PropClass == nullptr || DummyClass == nullptr) return;
+
+		const FVector Origin = PlayerController->GetPawn()->GetActorLocation() + PlayerController->GetPawn()->GetActorForwardVector() * 2000.0f;
+		TArray<AActor*> Actors;
+		for (int32 Index = 0; Index < NumActors; Index++) {
+			const FVector Offset((Index % 20 - 9.5f) * 150.0f, (Index / 20 - NumActors / 40.0f) * 150.0f, 0.0f);
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			Actors.Add(World->SpawnActor<AActor>(Index % 2 ? DummyClass : PropClass, FTransform(Origin + Offset), SpawnParams));
+		}
+
+		FSAreaEffect Effect;
+		Effect.Radius = 600.0f;
+		Effect.ImpulseStrength = 1.0f;
+		Effect.bVelChange = true;
+		Effect.Damage = 0.001f;
+
+		FRandomStream Random(NumEffects);
+		TArray<FVector> Locations;
+		for (int32 Index = 0; Index < NumEffects; Index++) {
+			Locations.Add(Origin + FVector(Random.FRandRange(-1500.0f, 1500.0f), Random.FRandRange(-1500.0f, 1500.0f), 50.0f));
+		}
+
+		// per component: the force component does its own overlap, then a second one finds actors to damage
+		AActor* ForceActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Origin));
+		URadialForceComponent* ForceComp = NewObject<URadialForceComponent>(ForceActor);
+		ForceActor->SetRootComponent(ForceComp);
+		ForceComp->Radius = Effect.Radius;
+		ForceComp->ImpulseStrength = Effect.ImpulseStrength;
+		ForceComp->bImpulseVelChange = Effect.bVelChange;
+		ForceComp->RegisterComponent();
+
+		double StartTime = FPlatformTime::Seconds();
+		for (const FVector& Location : Locations) {
+			ForceComp->SetWorldLocation(Location);
+			ForceComp->FireImpulse();
+
+			TArray<FOverlapResult> Overlaps;
+			World->OverlapMultiByObjectType(Overlaps, Location, FQuat::Identity,
+				FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllDynamicObjects),
+				FCollisionShape::MakeSphere(Effect.Radius));
+			for (const FOverlapResult& Overlap : Overlaps) {
+				AActor* Actor = Overlap.GetActor();
+				USAttributeComponent* AttributeComp = Actor ? Cast<USAttributeComponent>(Actor->GetComponentByClass(USAttributeComponent::StaticClass())) : nullptr;
+				if (AttributeComp) {
+					AttributeComp->ApplyHealthChange(-Effect.Damage);
+				}
+			}
+		}
+		const double ComponentSeconds = FPlatformTime::Seconds() - StartTime;
+		ForceActor->Destroy();
+
+		StartTime = FPlatformTime::Seconds();
+		int32 NumAffected = 0;
+		for (const FVector& Location : Locations) {
+			Effect.Location = Location;
+			NumAffected += AreaEffects->ApplyAreaEffect(Effect);
+		}
+		const double SharedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		for (AActor* Actor : Actors) {
+			if (Actor) Actor->Destroy();
+		}
+
+		UE_LOG(LogActionRoguelike, Display, TEXT("Area effect benchmark (%d actors, %d effects): force component %.2f us per effect, shared overlap %.2f us per effect (%.1f affected per effect)"),
+			NumActors, NumEffects, ComponentSeconds * 1e6 / NumEffects, SharedSeconds * 1e6 / NumEffects, (float)NumAffected / NumEffects);
+	}));
+
+// ActionRoguelike.InteractBenchmark [Count]: interact with a chest Count times through Implements and Execute_Interact,
+// then through the dispatch cache, and log the cost per call
+static FAutoConsoleCommandWithWorldAndArgs InteractBenchmarkCommand(
+	TEXT("ActionRoguelike.InteractBenchmark"),
+	TEXT("Compare Count (default 1000000) interactions through Execute_Interact and through the dispatch cache."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000000;
+		if (World == nullptr || Count <= 0) return;
+
+		AActor* Chest = World->SpawnActor<ASItemChest>(ASItemChest::StaticClass(), FTransform::Identity);
+		if (Chest == nullptr) return;
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Count; Index++) {
+			if (Chest->Implements<USGameplayInterface>()) {
+				ISGameplayInterface::Execute_Interact(Chest, nullptr);
+			}
+		}
+		const double ReflectionSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Count; Index++) {
+			ISGameplayInterface::DispatchInteract(Chest, nullptr);
+		}
+		const double CachedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		Chest->Destroy();
+
+		UE_LOG(LogActionRoguelike, Display, TEXT("Interact benchmark (%d calls): Execute_Interact %.1f ns per call, dispatch cache %.1f ns per call"),
+			Count, ReflectionSeconds * 1e9 / Count, CachedSeconds * 1e9 / Count);
+	}));
+
+#endif
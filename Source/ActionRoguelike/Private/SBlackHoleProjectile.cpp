@@ -2,4 +2,128 @@
 
 
 #include "SBlackHoleProjectile.h"
+#include "ActionRoguelike.h"
+#include "SAreaEffectSubsystem.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "PhysicsEngine/RadialForceComponent.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
 
+DECLARE_CYCLE_STAT(TEXT("BlackHole Forces"), STAT_BlackHoleForces, STATGROUP_ActionRoguelike);
+DECLARE_CYCLE_STAT(TEXT("BlackHole Refresh"), STAT_BlackHoleRefresh, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_COUNTER_STAT(TEXT("BlackHole Pulled Bodies"), STAT_BlackHolePulledBodies, STATGROUP_ActionRoguelike);
+
+ASBlackHoleProjectile::ASBlackHoleProjectile()
+{
+	// only overlaps with things that can move, so static level geometry never enters the set
+	InfluenceComp = CreateDefaultSubobject<USphereComponent>("InfluenceComp");
+	InfluenceComp->SetupAttachment(RootComponent);
+	InfluenceComp->InitSphereRadius(1000.0f);
+	InfluenceComp->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	InfluenceComp->SetCollisionObjectType(ECC_WorldDynamic);
+	InfluenceComp->SetCollisionResponseToAllChannels(ECR_Ignore);
+	InfluenceComp->SetCollisionResponseToChannel(ECC_WorldDynamic, ECR_Overlap);
+	InfluenceComp->SetCollisionResponseToChannel(ECC_PhysicsBody, ECR_Overlap);
+	InfluenceComp->SetGenerateOverlapEvents(true);
+}
+
+void ASBlackHoleProjectile::BeginPlay()
+{
+	// a radial force left in the blueprint would pull everything a second time
+	TInlineComponentArray<URadialForceComponent*> ForceComps(this);
+	for (URadialForceComponent* ForceComp : ForceComps) {
+		ForceComp->DestroyComponent();
+	}
+
+	InfluenceComp->OnComponentBeginOverlap.AddDynamic(this, &ASBlackHoleProjectile::OnInfluenceBeginOverlap);
+	InfluenceComp->OnComponentEndOverlap.AddDynamic(this, &ASBlackHoleProjectile::OnInfluenceEndOverlap);
+
+	Super::BeginPlay();
+
+	if (FPhysScene_Chaos* PhysScene = GetWorld()->GetPhysicsScene()) {
+		PhysScenePreTickHandle = PhysScene->OnPhysScenePreTick.AddUObject(this, &ASBlackHoleProjectile::ApplyForces);
+	}
+
+	RefreshInfluencedBodies();
+	GetWorldTimerManager().SetTimer(RefreshTimerHandle, this, &ASBlackHoleProjectile::RefreshInfluencedBodies, RefreshInterval, true);
+}
+
+void ASBlackHoleProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (FPhysScene_Chaos* PhysScene = GetWorld()->GetPhysicsScene()) {
+		PhysScene->OnPhysScenePreTick.Remove(PhysScenePreTickHandle);
+	}
+	GetWorldTimerManager().ClearTimer(RefreshTimerHandle);
+	InfluencedBodies.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASBlackHoleProjectile::OnInfluenceBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (OtherComp == nullptr || OtherActor == this || !OtherComp->IsSimulatingPhysics()) return;
+
+	InfluencedBodies.AddUnique(OtherComp);
+}
+
+void ASBlackHoleProjectile::OnInfluenceEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	// keep the order, the bodies waiting past the cap move up in the order they entered
+	InfluencedBodies.Remove(OtherComp);
+}
+
+void ASBlackHoleProjectile::RefreshInfluencedBodies()
+{
+	SCOPE_CYCLE_COUNTER(STAT_BlackHoleRefresh);
+
+	// the same object types the influence sphere overlaps
+	FCollisionObjectQueryParams ObjectQueryParams;
+	ObjectQueryParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	ObjectQueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+
+	TArray<FOverlapResult> Overlaps;
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(BlackHoleInfluence), false, this);
+	GetWorld()->OverlapMultiByObjectType(Overlaps, InfluenceComp->GetComponentLocation(), FQuat::Identity, ObjectQueryParams,
+		FCollisionShape::MakeSphere(InfluenceComp->GetScaledSphereRadius()), Params);
+
+	TSet<const UPrimitiveComponent*, DefaultKeyFuncs<const UPrimitiveComponent*>, TInlineSetAllocator<64>> InRange;
+	for (const FOverlapResult& Overlap : Overlaps) {
+		const UPrimitiveComponent* Body = Overlap.GetComponent();
+		if (Body && Body->IsSimulatingPhysics()) {
+			InRange.Add(Body);
+		}
+	}
+
+	InfluencedBodies.RemoveAll([&InRange](const TWeakObjectPtr<UPrimitiveComponent>& Body) { return !InRange.Contains(Body.Get()); });
+	for (const FOverlapResult& Overlap : Overlaps) {
+		UPrimitiveComponent* Body = Overlap.GetComponent();
+		if (Body && Body->IsSimulatingPhysics()) {
+			InfluencedBodies.AddUnique(Body);
+		}
+	}
+}
+
+void ASBlackHoleProjectile::ApplyForces(FPhysScene_Chaos* PhysScene, float DeltaTime)
+{
+	if (InfluencedBodies.Num() == 0) return;
+
+	USAreaEffectSubsystem* AreaEffects = GetWorld()->GetSubsystem<USAreaEffectSubsystem>();
+	if (AreaEffects == nullptr) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_BlackHoleForces);
+
+	TArray<UPrimitiveComponent*, TInlineAllocator<32>> Bodies;
+	for (int32 Index = 0; Index < InfluencedBodies.Num() && Bodies.Num() < MaxInfluencedBodies; Index++) {
+		UPrimitiveComponent* Body = InfluencedBodies[Index].Get();
+		if (Body == nullptr || !Body->IsSimulatingPhysics()) {
+			InfluencedBodies.RemoveAt(Index--);
+			continue;
+		}
+		Bodies.Add(Body);
+	}
+
+	// forces added before the step act on all of its substeps
+	const int32 NumPulled = AreaEffects->ApplyRadialForce(Bodies, GetActorLocation(), InfluenceComp->GetScaledSphereRadius(), -PullStrength, RIF_Linear, true);
+
+	INC_DWORD_STAT_BY(STAT_BlackHolePulledBodies, NumPulled);
+}
@@ -8,12 +8,20 @@
 #include "Camera/CameraComponent.h"
 #include "SInteractionComponent.h"
 #include "SAttributeComponent.h"
+#include "SHitFlashComponent.h"
+#include "SProjectileBase.h"
+#include "SMagicProjectile.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "ActionRoguelike.h"
 
 #include "DrawDebugHelpers.h"
 #include "Kismet/KismetMathLibrary.h"
 
-bool ASCharacter::bActiveTeleport = false;
-bool ASCharacter::bActiveBlackHole = false;
+DECLARE_CYCLE_STAT(TEXT("ServerSpawnProjectile"), STAT_ServerSpawnProjectile, STATGROUP_ActionRoguelike);
+
+// slack for the server cooldowns, the client timer started one trip before the server saw the spawn
+static const float ServerCooldownTolerance = 0.25f;
 
 // Sets default values
 ASCharacter::ASCharacter()
@@ -34,6 +42,9 @@ ASCharacter::ASCharacter()
 	bUseControllerRotationYaw = false;
 
 	AttributeComp = CreateDefaultSubobject<USAttributeComponent>("AttributeComp");
+
+	HitFlashComp = CreateDefaultSubobject<USHitFlashComponent>("HitFlashComp");
+	HitFlashComp->SetFlashMesh(GetMesh());
 }
 
 // Called when the game starts or when spawned
@@ -64,6 +75,11 @@ void ASCharacter::MoveRight(float value)
 
 void ASCharacter::PrimaryAttack() 
 {
+	// the server drops attacks faster than the fire rate
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now < NextPrimaryAttackTime) return;
+
+	NextPrimaryAttackTime = Now + PrimaryAttackInterval;
 	PlayAnimMontage(AttackAnim);
 
 	GetWorldTimerManager().SetTimer(TimerHandlePrimaryAttack, this, &ASCharacter::PrimaryAttack_TimeElapsed, 0.2f);
@@ -91,16 +107,142 @@ FTransform ASCharacter::ProjectileTransform() {
 	return FTransform(SpawnRotation, HandLocation);
 }
 
-void ASCharacter::PrimaryAttack_TimeElapsed()
+void ASCharacter::SpawnProjectile(TSubclassOf<ASProjectileBase> ProjectileClass)
 {
-	if (ensureAlways(MagicProjectileClass)) {
-		FTransform SpawnTM = ProjectileTransform();
+	FTransform SpawnTM = ProjectileTransform();
+
+	if (HasAuthority()) {
+		SpawnProjectileAt(ProjectileClass, SpawnTM, 0);
+		return;
+	}
+
+	// fly a local copy right away, it hands over to the server's projectile once that replicates
+	for (auto It = PredictedProjectiles.CreateIterator(); It; ++It) {
+		if (!It->Value.IsValid()) {
+			It.RemoveCurrent();
+		}
+	}
+
+	const int32 PredictionId = ++LastPredictionId;
+	if (ASProjectileBase* Predicted = SpawnProjectileAt(ProjectileClass, SpawnTM, PredictionId)) {
+		PredictedProjectiles.Add(PredictionId, Predicted);
+	}
+
+	ServerSpawnProjectile(ProjectileClass, SpawnTM, PredictionId);
+}
+
+ASProjectileBase* ASCharacter::SpawnProjectileAt(TSubclassOf<ASProjectileBase> ProjectileClass, const FTransform& SpawnTM, int32 PredictionId)
+{
+	if (!ProjectileClass) {
+		return nullptr;
+	}
+
+	ASProjectileBase* Projectile = GetWorld()->SpawnActorDeferred<ASProjectileBase>(ProjectileClass, SpawnTM, this, this, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Projectile) {
+		Projectile->SetPredictionId(PredictionId);
+		Projectile->FinishSpawning(SpawnTM);
+	}
+	return Projectile;
+}
+
+void ASCharacter::ServerSpawnProjectile_Implementation(TSubclassOf<ASProjectileBase> ProjectileClass, const FTransform& SpawnTM, int32 PredictionId)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ServerSpawnProjectile);
+
+	const bool bInReach = FVector::DistSquared(SpawnTM.GetLocation(), GetActorLocation()) <= FMath::Square(MaxProjectileSpawnDistance);
+	if (!bInReach || !ConsumeServerCooldown(ProjectileClass)) {
+		INC_DWORD_STAT(STAT_ActionRoguelike_RejectedProjectiles);
+		ClientRejectProjectile(PredictionId);
+		return;
+	}
+
+	for (auto It = ServerPredictedProjectiles.CreateIterator(); It; ++It) {
+		if (!It->Value.IsValid()) {
+			It.RemoveCurrent();
+		}
+	}
+
+	if (ASProjectileBase* Projectile = SpawnProjectileAt(ProjectileClass, SpawnTM, PredictionId)) {
+		ServerPredictedProjectiles.Add(PredictionId, Projectile);
+	}
+}
+
+bool ASCharacter::ServerSpawnProjectile_Validate(TSubclassOf<ASProjectileBase> ProjectileClass, const FTransform& SpawnTM, int32 PredictionId)
+{
+	return ProjectileClass && (ProjectileClass == MagicProjectileClass || ProjectileClass == BlackHoleProjectileClass || ProjectileClass == TeleportProjectileClass);
+}
+
+void ASCharacter::ClientRejectProjectile_Implementation(int32 PredictionId)
+{
+	TWeakObjectPtr<ASProjectileBase> Predicted;
+	if (PredictedProjectiles.RemoveAndCopyValue(PredictionId, Predicted) && Predicted.IsValid()) {
+		Predicted->Destroy();
+	}
+}
+
+void ASCharacter::ReconcileProjectile(ASProjectileBase* Replicated)
+{
+	TWeakObjectPtr<ASProjectileBase> Predicted;
+	if (PredictedProjectiles.RemoveAndCopyValue(Replicated->GetPredictionId(), Predicted) && Predicted.IsValid()) {
+		Replicated->TakeOverFrom(Predicted.Get());
+	}
+}
+
+void ASCharacter::ServerClaimProjectileHit_Implementation(int32 PredictionId, AActor* Target, FVector_NetQuantize HitLocation, double ViewTime)
+{
+	// one claim per projectile
+	TWeakObjectPtr<ASProjectileBase> Projectile;
+	ServerPredictedProjectiles.RemoveAndCopyValue(PredictionId, Projectile);
+
+	if (ASMagicProjectile* MagicProjectile = Cast<ASMagicProjectile>(Projectile.Get())) {
+		MagicProjectile->ConfirmPredictedHit(Target, HitLocation, ViewTime);
+	}
+}
+
+double ASCharacter::GetViewedServerTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const double ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	// other pawns are shown as the server had them half a round trip ago
+	const APlayerState* State = GetPlayerState();
+	return State ? ServerTime - State->GetPingInMilliseconds() * 0.0005 : ServerTime;
+}
+
+bool ASCharacter::ConsumeServerCooldown(TSubclassOf<ASProjectileBase> ProjectileClass)
+{
+	float* ReadyTime = nullptr;
+	float Cooldown = 0.0f;
+	if (ProjectileClass == MagicProjectileClass) {
+		ReadyTime = &ServerPrimaryAttackReadyTime;
+		Cooldown = PrimaryAttackInterval;
+	}
+	else if (ProjectileClass == BlackHoleProjectileClass) {
+		ReadyTime = &ServerBlackHoleReadyTime;
+		Cooldown = BlackHoleCooldown;
+	}
+	else if (ProjectileClass == TeleportProjectileClass) {
+		ReadyTime = &ServerTeleportReadyTime;
+		Cooldown = TeleportCooldown;
+	}
+	else {
+		return true;
+	}
 
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnParams.Instigator = this;
+	// the slack can't be more than half the cooldown, or a short one like the fire rate isn't checked at all
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now < *ReadyTime - FMath::Min(ServerCooldownTolerance, Cooldown * 0.5f)) {
+		return false;
+	}
 
-		GetWorld()->SpawnActor<AActor>(MagicProjectileClass, SpawnTM, SpawnParams);
+	*ReadyTime = Now + Cooldown;
+	return true;
+}
+
+void ASCharacter::PrimaryAttack_TimeElapsed()
+{
+	if (ensureAlways(MagicProjectileClass)) {
+		SpawnProjectile(MagicProjectileClass);
 	}
 }
 
@@ -117,14 +259,8 @@ void ASCharacter::SecondaryAttack()
 void ASCharacter::SecondaryAttack_TimeElapsed()
 {
 	if (ensureAlways(BlackHoleProjectileClass)) {
-		FTransform SpawnTM = ProjectileTransform();
-
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnParams.Instigator = this;
-
-		GetWorld()->SpawnActor<AActor>(BlackHoleProjectileClass, SpawnTM, SpawnParams);
-		GetWorldTimerManager().SetTimer(TimerHandleSecondaryAttack, this, &ASCharacter::ResetActiveBlackHole, 5.0f);
+		SpawnProjectile(BlackHoleProjectileClass);
+		GetWorldTimerManager().SetTimer(TimerHandleSecondaryAttack, this, &ASCharacter::ResetActiveBlackHole, BlackHoleCooldown);
 	}
 }
 
@@ -145,14 +281,8 @@ void ASCharacter::Teleport()
 void ASCharacter::Teleport_TimeElapsed()
 {
 	if (ensureAlways(TeleportProjectileClass)) {
-		FTransform SpawnTM = ProjectileTransform();
-
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnParams.Instigator = this;
-
-		GetWorld()->SpawnActor<AActor>(TeleportProjectileClass, SpawnTM, SpawnParams);
-		GetWorldTimerManager().SetTimer(TimerHandleTeleport, this, &ASCharacter::ResetActiveTeleport, 2.0f);
+		SpawnProjectile(TeleportProjectileClass);
+		GetWorldTimerManager().SetTimer(TimerHandleTeleport, this, &ASCharacter::ResetActiveTeleport, TeleportCooldown);
 	}
 }
 
@@ -161,6 +291,17 @@ void ASCharacter::ResetActiveTeleport() {
 }
 
 void ASCharacter::PrimaryInteract()
+{
+	if (!HasAuthority()) {
+		ServerPrimaryInteract();
+		return;
+	}
+	if (InteractionComp) {
+		InteractionComp->PrimaryInteract();
+	}
+}
+
+void ASCharacter::ServerPrimaryInteract_Implementation()
 {
 	if (InteractionComp) {
 		InteractionComp->PrimaryInteract();
@@ -169,8 +310,7 @@ void ASCharacter::PrimaryInteract()
 
 void ASCharacter::OnHealthChange(AActor* InstigatorActor, USAttributeComponent* OwningComp, float NewHealth, float Delta)
 {
-	GetMesh()->SetScalarParameterValueOnMaterials("TimeToHit", GetWorld()->TimeSeconds);
-	GetMesh()->SetVectorParameterValueOnMaterials("FlashColor", FVector(1.0f, 0.0f, 0.0f));
+	HitFlashComp->Flash();
 
 	if (NewHealth <= 0.0f && Delta < 0.0f)
 	{
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SExplosionSubsystem.h"
+#include "ActionRoguelike.h"
+#include "SAttributeComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Explosions Resolve"), STAT_ExplosionsResolve, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosions Resolved"), STAT_ExplosionsResolved, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Clusters"), STAT_ExplosionClusters, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Explosions Queued"), STAT_ExplosionsQueued, STATGROUP_ActionRoguelike);
+
+bool USExplosionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USExplosionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USExplosionSubsystem, STATGROUP_Tickables);
+}
+
+bool USExplosionSubsystem::QueueExplosion(const FSExplosion& Explosion)
+{
+	if (Explosion.Source.IsValid()) {
+		bool bAlreadyPending = false;
+		PendingSources.Add(Explosion.Source.Get(), &bAlreadyPending);
+		if (bAlreadyPending) return false;
+	}
+
+	Queue.Add(Explosion);
+	SET_DWORD_STAT(STAT_ExplosionsQueued, Queue.Num());
+	return true;
+}
+
+bool USExplosionSubsystem::IsExplosionPending(const AActor* Source) const
+{
+	return Source && PendingSources.Contains(Source);
+}
+
+void USExplosionSubsystem::Tick(float DeltaTime)
+{
+	if (Queue.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_ExplosionsResolve);
+
+	// take this frame's share out of the queue first, explosions they set off wait for the next frame
+	const int32 NumExplosions = FMath::Min(Queue.Num(), MaxExplosionsPerFrame);
+	TArray<FSExplosion> Explosions(Queue.GetData(), NumExplosions);
+	Queue.RemoveAt(0, NumExplosions, false);
+	for (const FSExplosion& Explosion : Explosions) {
+		PendingSources.Remove(Explosion.Source.Get());
+	}
+
+	TArray<FCluster> Clusters;
+	BuildClusters(Explosions, Clusters);
+	TArray<FSAreaEffect> Effects;
+	for (const FCluster& Cluster : Clusters) {
+		ResolveCluster(Cluster, Explosions, Effects);
+	}
+
+	INC_DWORD_STAT_BY(STAT_ExplosionsResolved, NumExplosions);
+	INC_DWORD_STAT_BY(STAT_ExplosionClusters, Clusters.Num());
+	SET_DWORD_STAT(STAT_ExplosionsQueued, Queue.Num());
+}
+
+void USExplosionSubsystem::BuildClusters(TConstArrayView<FSExplosion> Explosions, TArray<FCluster>& OutClusters) const
+{
+	for (int32 Index = 0; Index < Explosions.Num(); Index++) {
+		const FSExplosion& Explosion = Explosions[Index];
+
+		bool bJoined = false;
+		for (FCluster& Cluster : OutClusters) {
+			// smallest sphere enclosing the cluster sphere and the explosion sphere
+			const FVector Offset = Explosion.Effect.Location - Cluster.Center;
+			const float Distance = Offset.Size();
+			if (Distance > Cluster.Radius + Explosion.Effect.Radius) continue;
+
+			float Radius = Cluster.Radius;
+			FVector Center = Cluster.Center;
+			if (Distance + Explosion.Effect.Radius > Cluster.Radius) {
+				if (Distance + Cluster.Radius <= Explosion.Effect.Radius) {
+					Radius = Explosion.Effect.Radius;
+					Center = Explosion.Effect.Location;
+				}
+				else {
+					Radius = (Cluster.Radius + Distance + Explosion.Effect.Radius) * 0.5f;
+					Center = Cluster.Center + Offset / Distance * (Radius - Cluster.Radius);
+				}
+			}
+			if (Radius > Explosion.Effect.Radius * MaxClusterRadiusScale) continue;
+
+			Cluster.Center = Center;
+			Cluster.Radius = Radius;
+			Cluster.Explosions.Add(Index);
+			bJoined = true;
+			break;
+		}
+
+		if (!bJoined) {
+			FCluster& Cluster = OutClusters.AddDefaulted_GetRef();
+			Cluster.Center = Explosion.Effect.Location;
+			Cluster.Radius = Explosion.Effect.Radius;
+			Cluster.Explosions.Add(Index);
+		}
+	}
+}
+
+void USExplosionSubsystem::ResolveCluster(const FCluster& Cluster, TConstArrayView<FSExplosion> Explosions, TArray<FSAreaEffect>& Effects)
+{
+	USAreaEffectSubsystem* AreaEffects = GetWorld()->GetSubsystem<USAreaEffectSubsystem>();
+	if (AreaEffects == nullptr) return;
+
+	Effects.Reset();
+	for (const int32 Index : Cluster.Explosions) {
+		Effects.Add(Explosions[Index].Effect);
+	}
+	AreaEffects->ApplyAreaEffects(Effects, Cluster.Center, Cluster.Radius);
+
+	for (const int32 Index : Cluster.Explosions) {
+		const FSExplosion& Explosion = Explosions[Index];
+		if (USAttributeComponent* AttributeComp = USAttributeComponent::GetAttributes(Explosion.Target.Get())) {
+			AttributeComp->ApplyHealthChange(-Explosion.Damage);
+		}
+	}
+}
@@ -6,13 +6,13 @@
 #include "Components/BoxComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "PhysicsEngine/RadialForceComponent.h"
-#include "SAttributeComponent.h"
+#include "SExplosionSubsystem.h"
 
 // Sets default values
 ASExplosiveBarrel::ASExplosiveBarrel()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// nothing to do per frame, explosions are resolved by the explosion subsystem
+	PrimaryActorTick.bCanEverTick = false;
 
 	MeshComp = CreateDefaultSubobject<UStaticMeshComponent>("MeshComp");
 	RootComponent = MeshComp;
@@ -29,6 +29,8 @@ ASExplosiveBarrel::ASExplosiveBarrel()
 	BoxComp->SetRelativeTransform(scale);
 
 	MeshComp->SetSimulatePhysics(true);
+	// stay asleep until something hits or pushes the barrel
+	MeshComp->BodyInstance.bStartAwake = false;
 }
 
 // Called when the game starts or when spawned
@@ -39,21 +41,29 @@ void ASExplosiveBarrel::BeginPlay()
 	BoxComp->OnComponentHit.AddDynamic(this, &ASExplosiveBarrel::Explode);
 }
 
-// Called every frame
-void ASExplosiveBarrel::Tick(float DeltaTime)
+void ASExplosiveBarrel::Explode(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
-	Super::Tick(DeltaTime);
+	// every contact of a tumbling barrel reports a hit, only the first one until the explosion is resolved counts
+	USExplosionSubsystem* Explosions = GetWorld()->GetSubsystem<USExplosionSubsystem>();
+	if (Explosions == nullptr || Explosions->IsExplosionPending(this)) return;
 
+	Detonate(OtherActor);
+	DrawDebugString(GetWorld(), Hit.ImpactPoint, TEXT("bonk!"), nullptr, FColor::White, 2.0f, true);
 }
 
-void ASExplosiveBarrel::Explode(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+void ASExplosiveBarrel::Detonate(AActor* Target)
 {
-	ForceComp->FireImpulse();
-	DrawDebugString(GetWorld(), Hit.ImpactPoint, TEXT("bonk!"), nullptr, FColor::White, 2.0f, true);
-	if (OtherActor) {
-		USAttributeComponent* AttributeComp = Cast<USAttributeComponent>(OtherActor->GetComponentByClass(USAttributeComponent::StaticClass()));
-		if (AttributeComp) {
-			AttributeComp->ApplyHealthChange(-50.0f);
-		}
-	}
+	USExplosionSubsystem* Explosions = GetWorld()->GetSubsystem<USExplosionSubsystem>();
+	if (Explosions == nullptr) return;
+
+	FSExplosion Explosion;
+	Explosion.Effect.Location = ForceComp->GetComponentLocation();
+	Explosion.Effect.Radius = ForceComp->Radius;
+	Explosion.Effect.ImpulseStrength = ForceComp->ImpulseStrength;
+	Explosion.Effect.Falloff = ForceComp->Falloff;
+	Explosion.Effect.bVelChange = ForceComp->bImpulseVelChange;
+	Explosion.Damage = Damage;
+	Explosion.Target = Target;
+	Explosion.Source = this;
+	Explosions->QueueExplosion(Explosion);
 }
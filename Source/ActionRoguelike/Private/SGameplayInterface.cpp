@@ -2,5 +2,54 @@
 
 
 #include "SGameplayInterface.h"
+#include "UObject/ObjectKey.h"
 
 // Add default functionality here for any ISGameplayInterface functions that are not pure virtual.
+
+namespace
+{
+	enum class EInteractDispatch : uint8
+	{
+		// the class doesn't implement the interface
+		None,
+		// native Interact_Implementation, called directly
+		Native,
+		// implemented or overridden in blueprint, goes through ProcessEvent
+		Blueprint
+	};
+
+	// resolved dispatch per class, game thread only
+	TMap<TObjectKey<UClass>, EInteractDispatch> InteractDispatchCache;
+
+	EInteractDispatch ResolveInteractDispatch(const UClass* Class)
+	{
+		if (!Class->ImplementsInterface(USGameplayInterface::StaticClass())) return EInteractDispatch::None;
+
+		// a blueprint override shows up as a non-native function on the class, the interface's own is native
+		const UFunction* Function = Class->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(ISGameplayInterface, Interact));
+		const bool bNativeInterface = Class->GetDefaultObject()->GetNativeInterfaceAddress(USGameplayInterface::StaticClass()) != nullptr;
+		return bNativeInterface && Function && Function->HasAnyFunctionFlags(FUNC_Native) ? EInteractDispatch::Native : EInteractDispatch::Blueprint;
+	}
+}
+
+bool ISGameplayInterface::DispatchInteract(AActor* Actor, APawn* InstigatorPawn)
+{
+	if (Actor == nullptr) return false;
+
+	const UClass* Class = Actor->GetClass();
+	EInteractDispatch* Dispatch = InteractDispatchCache.Find(Class);
+	if (Dispatch == nullptr) {
+		Dispatch = &InteractDispatchCache.Add(Class, ResolveInteractDispatch(Class));
+	}
+
+	switch (*Dispatch) {
+	case EInteractDispatch::Native:
+		static_cast<ISGameplayInterface*>(Actor->GetNativeInterfaceAddress(USGameplayInterface::StaticClass()))->Interact_Implementation(InstigatorPawn);
+		return true;
+	case EInteractDispatch::Blueprint:
+		Execute_Interact(Actor, InstigatorPawn);
+		return true;
+	default:
+		return false;
+	}
+}
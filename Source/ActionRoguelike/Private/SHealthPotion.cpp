@@ -4,6 +4,7 @@
 #include "SHealthPotion.h"
 #include "SAttributeComponent.h"
 #include "Components/StaticMeshComponent.h"
+#include "Net/UnrealNetwork.h"
 
 ASHealthPotion::ASHealthPotion()
 {
@@ -12,6 +13,20 @@ ASHealthPotion::ASHealthPotion()
 
 	IsActive = true;
 	HealAmount = 40.0f;
+
+	bReplicates = true;
+}
+
+void ASHealthPotion::OnRep_IsActive()
+{
+	MeshComp->SetVisibility(IsActive);
+}
+
+void ASHealthPotion::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASHealthPotion, IsActive);
 }
 
 void ASHealthPotion::Reactivate()
@@ -23,13 +38,29 @@ void ASHealthPotion::Reactivate()
 void ASHealthPotion::Interact_Implementation(APawn* InstigatorPawn)
 {
 	if (!IsActive) return;
-	USAttributeComponent* AttributeComponent = Cast<USAttributeComponent>(InstigatorPawn->GetComponentByClass(USAttributeComponent::StaticClass()));
+	USAttributeComponent* AttributeComponent = USAttributeComponent::GetAttributes(InstigatorPawn);
+
+	if (AttributeComponent == nullptr || AttributeComponent->IsMaxHealth()) return;
 
-	if (AttributeComponent->IsMaxHealth()) return;
+	// only used up where the heal was applied, on the server
+	if (!AttributeComponent->ApplyHealthChange(HealAmount)) return;
 
-	AttributeComponent->ApplyHealthChange(HealAmount);
-	
 	IsActive = false;
 	MeshComp->SetVisibility(false);
-	GetWorldTimerManager().SetTimer(TimerHandle, this, &ASHealthPotion::Reactivate, 10.0f);
+	GetWorldTimerManager().SetTimer(TimerHandle, this, &ASHealthPotion::Reactivate, ReactivateDelay);
+}
+
+void ASHealthPotion::SerializeSaveState(FArchive& Ar, int32 Version)
+{
+	// an inactive potion keeps the time it still had left
+	float RemainingTime = IsActive ? 0.0f : GetWorldTimerManager().GetTimerRemaining(TimerHandle);
+	Ar << IsActive << RemainingTime;
+
+	if (Ar.IsLoading()) {
+		MeshComp->SetVisibility(IsActive);
+		GetWorldTimerManager().ClearTimer(TimerHandle);
+		if (!IsActive) {
+			GetWorldTimerManager().SetTimer(TimerHandle, this, &ASHealthPotion::Reactivate, FMath::Max(RemainingTime, UE_KINDA_SMALL_NUMBER));
+		}
+	}
 }
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SHitFlashComponent.h"
+#include "ActionRoguelike.h"
+#include "Components/MeshComponent.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("HitFlash Updates"), STAT_HitFlashUpdates, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("HitFlash MIDs"), STAT_HitFlashMIDs, STATGROUP_ActionRoguelike);
+DECLARE_MEMORY_STAT(TEXT("HitFlash MID Memory"), STAT_HitFlashMIDMemory, STATGROUP_ActionRoguelike);
+
+static const FName TimeToHitName("TimeToHit");
+static const FName FlashColorName("FlashColor");
+
+USHitFlashComponent::USHitFlashComponent()
+{
+	// only ticks for the frame after a flash, in post update work so all hits of the frame are in
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void USHitFlashComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (FlashMesh == nullptr) {
+		FlashMesh = GetOwner()->FindComponentByClass<UMeshComponent>();
+	}
+	if (FlashMesh == nullptr || bUseCustomPrimitiveData) return;
+
+	// the one time the instances are made, hits only set parameters on them
+	for (int32 Index = 0; Index < FlashMesh->GetNumMaterials(); Index++) {
+		UMaterialInstanceDynamic* Material = FlashMesh->CreateDynamicMaterialInstance(Index);
+		if (Material == nullptr) continue;
+
+		FlashMaterials.Add(Material);
+		INC_DWORD_STAT(STAT_HitFlashMIDs);
+		INC_MEMORY_STAT_BY(STAT_HitFlashMIDMemory, Material->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+	}
+}
+
+void USHitFlashComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (UMaterialInstanceDynamic* Material : FlashMaterials) {
+		DEC_DWORD_STAT(STAT_HitFlashMIDs);
+		DEC_MEMORY_STAT_BY(STAT_HitFlashMIDMemory, Material->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+	}
+	FlashMaterials.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USHitFlashComponent::Flash()
+{
+	PendingTimeToHit = GetWorld()->TimeSeconds;
+	SetComponentTickEnabled(true);
+}
+
+void USHitFlashComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	SetComponentTickEnabled(false);
+	if (FlashMesh == nullptr) return;
+
+	INC_DWORD_STAT(STAT_HitFlashUpdates);
+
+	if (bUseCustomPrimitiveData) {
+		FlashMesh->SetCustomPrimitiveDataFloat(TimeToHitIndex, PendingTimeToHit);
+		if (bWriteFlashColor) {
+			FlashMesh->SetCustomPrimitiveDataVector3(TimeToHitIndex + 1, FVector(FlashColor.R, FlashColor.G, FlashColor.B));
+		}
+		return;
+	}
+
+	for (UMaterialInstanceDynamic* Material : FlashMaterials) {
+		Material->SetScalarParameterValue(TimeToHitName, PendingTimeToHit);
+		if (bWriteFlashColor) {
+			Material->SetVectorParameterValue(FlashColorName, FlashColor);
+		}
+	}
+}
@@ -76,11 +76,10 @@ void USInteractionComponent::PrimaryInteract()
 
 		if (HitActor)
 		{
-			if (HitActor->Implements<USGameplayInterface>())
-			{
-				APawn* MyPawn = Cast<APawn>(GetOwner());
+			APawn* MyPawn = Cast<APawn>(GetOwner());
 
-				ISGameplayInterface::Execute_Interact(HitActor, MyPawn);
+			if (ISGameplayInterface::DispatchInteract(HitActor, MyPawn))
+			{
 				break;
 			}
 		}
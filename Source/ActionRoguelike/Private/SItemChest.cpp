@@ -4,6 +4,7 @@
 #include "SItemChest.h"
 
 #include "Components/StaticMeshComponent.h"
+#include "Net/UnrealNetwork.h"
 
 // Sets default values
 ASItemChest::ASItemChest()
@@ -18,6 +19,15 @@ ASItemChest::ASItemChest()
 	LidMesh->SetupAttachment(BaseMesh);
 
 	TargetPitch = 110.0;
+
+	bReplicates = true;
+}
+
+void ASItemChest::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASItemChest, bLidOpen);
 }
 
 // Called when the game starts or when spawned
@@ -36,6 +46,21 @@ void ASItemChest::Tick(float DeltaTime)
 
 void ASItemChest::Interact_Implementation(APawn* InstigatorPawn)
 {
-	LidMesh->SetRelativeRotation(FRotator(TargetPitch, 0, 0));
+	bLidOpen = true;
+	UpdateLid();
+}
+
+void ASItemChest::UpdateLid()
+{
+	LidMesh->SetRelativeRotation(FRotator(bLidOpen ? TargetPitch : 0.0f, 0, 0));
+}
+
+void ASItemChest::SerializeSaveState(FArchive& Ar, int32 Version)
+{
+	Ar << bLidOpen;
+
+	if (Ar.IsLoading()) {
+		UpdateLid();
+	}
 }
 
@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SLagCompensationSubsystem.h"
+#include "ActionRoguelike.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+DECLARE_CYCLE_STAT(TEXT("LagCompensation Record"), STAT_LagCompensationRecord, STATGROUP_ActionRoguelike);
+DECLARE_CYCLE_STAT(TEXT("LagCompensation Rewind"), STAT_LagCompensationRewind, STATGROUP_ActionRoguelike);
+
+const double USLagCompensationSubsystem::MaxRewindSeconds = 0.5;
+const double USLagCompensationSubsystem::RecordInterval = 1.0 / 120.0;
+// one more sample for the part of an interval at either end
+const int32 USLagCompensationSubsystem::HistoryCapacity = FMath::CeilToInt(MaxRewindSeconds / RecordInterval) + 2;
+
+FSHitboxHistory::FSHitboxHistory(int32 InCapacity)
+{
+	Samples.SetNum(FMath::Max(InCapacity, 2));
+}
+
+void FSHitboxHistory::Record(double Time, const FVector& Location)
+{
+	if (NumSamples < Samples.Num()) {
+		Samples[(Head + NumSamples) % Samples.Num()] = { Time, Location };
+		NumSamples++;
+	}
+	else {
+		Samples[Head] = { Time, Location };
+		Head = (Head + 1) % Samples.Num();
+	}
+}
+
+double FSHitboxHistory::GetOldestTime() const
+{
+	return NumSamples > 0 ? GetSample(0).Time : 0.0;
+}
+
+bool FSHitboxHistory::Rewind(double Time, FVector& OutLocation) const
+{
+	if (NumSamples == 0) return false;
+
+	if (Time <= GetSample(0).Time) {
+		OutLocation = GetSample(0).Location;
+		return true;
+	}
+	if (Time >= GetSample(NumSamples - 1).Time) {
+		OutLocation = GetSample(NumSamples - 1).Location;
+		return true;
+	}
+
+	// first sample newer than Time, the samples are in time order
+	int32 Low = 1;
+	int32 High = NumSamples - 1;
+	while (Low < High) {
+		const int32 Mid = (Low + High) / 2;
+		if (GetSample(Mid).Time <= Time) {
+			Low = Mid + 1;
+		}
+		else {
+			High = Mid;
+		}
+	}
+
+	const FSHitboxSample& Before = GetSample(Low - 1);
+	const FSHitboxSample& After = GetSample(Low);
+	const double Alpha = (Time - Before.Time) / FMath::Max(After.Time - Before.Time, UE_DOUBLE_SMALL_NUMBER);
+	OutLocation = FMath::Lerp(Before.Location, After.Location, Alpha);
+	return true;
+}
+
+float USLagCompensationSubsystem::DistanceToCapsule(const FVector& Point, const FVector& Center, float Radius, float HalfHeight)
+{
+	const float SegmentHalfLength = FMath::Max(HalfHeight - Radius, 0.0f);
+	const FVector Top = Center + FVector(0.0f, 0.0f, SegmentHalfLength);
+	const FVector Bottom = Center - FVector(0.0f, 0.0f, SegmentHalfLength);
+	const FVector Closest = FMath::ClosestPointOnSegment(Point, Bottom, Top);
+	return FMath::Max(FVector::Dist(Point, Closest) - Radius, 0.0f);
+}
+
+bool USLagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USLagCompensationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// the net mode is known by now, clients and standalone games have nothing to validate
+	if (!IsServer()) return;
+
+	for (TActorIterator<APawn> It(&InWorld); It; ++It) {
+		TrackPawn(*It);
+	}
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &USLagCompensationSubsystem::OnActorSpawned));
+}
+
+void USLagCompensationSubsystem::Deinitialize()
+{
+	if (ActorSpawnedHandle.IsValid()) {
+		GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		ActorSpawnedHandle.Reset();
+	}
+	TrackedPawns.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId USLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+bool USLagCompensationSubsystem::IsServer() const
+{
+	const ENetMode NetMode = GetWorld()->GetNetMode();
+	return NetMode == NM_DedicatedServer || NetMode == NM_ListenServer;
+}
+
+void USLagCompensationSubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (APawn* Pawn = Cast<APawn>(Actor)) {
+		TrackPawn(Pawn);
+	}
+}
+
+void USLagCompensationSubsystem::TrackPawn(APawn* Pawn)
+{
+	FTrackedPawn& Tracked = TrackedPawns.Emplace(Pawn, FTrackedPawn{ Pawn, FSHitboxHistory(HistoryCapacity) });
+	Pawn->GetSimpleCollisionCylinder(Tracked.History.Radius, Tracked.History.HalfHeight);
+}
+
+void USLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	if (TrackedPawns.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_LagCompensationRecord);
+
+	// on the interval grid, a frame that comes in late doesn't push back the samples after it
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (Now < NextRecordTime) return;
+	NextRecordTime = FMath::Max(NextRecordTime + RecordInterval, Now);
+
+	for (auto It = TrackedPawns.CreateIterator(); It; ++It) {
+		APawn* Pawn = It->Value.Pawn.Get();
+		if (Pawn == nullptr || Pawn->IsPendingKillPending()) {
+			It.RemoveCurrent();
+			continue;
+		}
+		It->Value.History.Record(Now, Pawn->GetActorLocation());
+	}
+}
+
+bool USLagCompensationSubsystem::IsTracked(const AActor* Actor) const
+{
+	return Actor && TrackedPawns.Contains(Actor);
+}
+
+bool USLagCompensationSubsystem::ValidateHit(const AActor* Target, const FVector& HitLocation, double Time, float Tolerance) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_LagCompensationRewind);
+
+	const FTrackedPawn* Tracked = Target ? TrackedPawns.Find(Target) : nullptr;
+	if (Tracked == nullptr) return false;
+
+	// never rewind further than the history promises, or into the future
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double RewindTime = FMath::Clamp(Time, Now - MaxRewindSeconds, Now);
+
+	FVector Location;
+	if (!Tracked->History.Rewind(RewindTime, Location)) return false;
+
+	return DistanceToCapsule(HitLocation, Location, Tracked->History.Radius, Tracked->History.HalfHeight) <= Tolerance;
+}
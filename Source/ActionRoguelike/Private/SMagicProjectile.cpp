@@ -4,6 +4,9 @@
 
 #include "Components/SphereComponent.h"
 #include "SAttributeComponent.h"
+#include "SCharacter.h"
+#include "SLagCompensationSubsystem.h"
+#include "GameFramework/ProjectileMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystem.h"
 
@@ -24,12 +27,58 @@ void ASMagicProjectile::OnActorOverlap(UPrimitiveComponent* OverlappedComponent,
 	//UGameplayStatics::PlaySoundAtLocation(GetWorld(), ImpactSoundBase, OtherActor->GetActorLocation());
 	if (OtherActor && OtherActor != GetInstigator())
 	{
-		USAttributeComponent* AttributeComp = Cast<USAttributeComponent>(OtherActor->GetComponentByClass(USAttributeComponent::StaticClass()));
+		USAttributeComponent* AttributeComp = USAttributeComponent::GetAttributes(OtherActor);
 
 		if (AttributeComp) {
-			UGameplayStatics::PlayWorldCameraShake(GetWorld(), CameraShakeDamage, OtherActor->GetActorLocation(), 0.0f, 1000.0f);
-			AttributeComp->ApplyHealthChange(-20.0f);
-			Destroy();
+			// client: show the hit now, the server checks it against where the pawn was when we saw it
+			if (IsPredicted()) {
+				ASCharacter* Shooter = Cast<ASCharacter>(GetInstigator());
+				if (Shooter && OtherActor->IsA<APawn>()) {
+					Shooter->ServerClaimProjectileHit(PredictionId, OtherActor, GetActorLocation(), Shooter->GetViewedServerTime());
+				}
+				UGameplayStatics::PlayWorldCameraShake(GetWorld(), CameraShakeDamage, OtherActor->GetActorLocation(), 0.0f, 1000.0f);
+				Destroy();
+				return;
+			}
+
+			// remote copies wait for the server to destroy them
+			if (!HasGameplayAuthority()) {
+				return;
+			}
+
+			// pawns are hit through the shooter's claim, the server copy is half a round trip behind what the shooter saw
+			USLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<USLagCompensationSubsystem>();
+			if (PredictionId != 0 && LagCompensation && LagCompensation->IsTracked(OtherActor)) {
+				return;
+			}
+
+			ApplyHit(OtherActor, AttributeComp);
 		}
 	}
 }
+
+void ASMagicProjectile::ConfirmPredictedHit(AActor* Target, const FVector& HitLocation, double ViewTime)
+{
+	USLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<USLagCompensationSubsystem>();
+	USAttributeComponent* AttributeComp = USAttributeComponent::GetAttributes(Target);
+
+	// the claimed hit has to be within the flight the server copy could still catch up on
+	const float Reach = ProjectileMovementComp->InitialSpeed * USLagCompensationSubsystem::MaxRewindSeconds + HitTolerance;
+	const bool bInReach = FVector::DistSquared(GetActorLocation(), HitLocation) <= FMath::Square(Reach);
+
+	if (LagCompensation && AttributeComp && bInReach
+		&& LagCompensation->ValidateHit(Target, HitLocation, ViewTime, SphereComp->GetScaledSphereRadius() + HitTolerance)) {
+		ApplyHit(Target, AttributeComp);
+		return;
+	}
+
+	// the shooter's copy is gone either way
+	Destroy();
+}
+
+void ASMagicProjectile::ApplyHit(AActor* OtherActor, USAttributeComponent* AttributeComp)
+{
+	UGameplayStatics::PlayWorldCameraShake(GetWorld(), CameraShakeDamage, OtherActor->GetActorLocation(), 0.0f, 1000.0f);
+	AttributeComp->ApplyHealthChange(-Damage);
+	Destroy();
+}
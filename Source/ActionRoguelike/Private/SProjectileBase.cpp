@@ -2,6 +2,9 @@
 
 
 #include "SProjectileBase.h"
+#include "ActionRoguelike.h"
+#include "SCharacter.h"
+#include "Net/UnrealNetwork.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
 #include "Particles/ParticleSystemComponent.h"
@@ -27,13 +30,66 @@ ASProjectileBase::ASProjectileBase()
 
 	AudioComp = CreateDefaultSubobject<UAudioComponent>("AudioComp");
 	AudioComp->SetupAttachment(RootComponent);
+
+	// clients simulate the flight from the spawn velocity, so only spawn and destroy go over the wire.
+	// a low update rate and cull distance keep many projectiles from costing a full channel update each frame
+	bReplicates = true;
+	SetReplicatingMovement(false);
+	NetUpdateFrequency = 5.0f;
+	MinNetUpdateFrequency = 1.0f;
+	NetPriority = 0.5f;
+	NetCullDistanceSquared = FMath::Square(8000.0f);
+}
+
+bool ASProjectileBase::IsPredicted() const
+{
+	return GetNetMode() == NM_Client && GetLocalRole() == ROLE_Authority;
+}
+
+bool ASProjectileBase::HasGameplayAuthority() const
+{
+	return GetNetMode() != NM_Client && HasAuthority();
+}
+
+void ASProjectileBase::TakeOverFrom(ASProjectileBase* Predicted)
+{
+	SetActorLocationAndRotation(Predicted->GetActorLocation(), Predicted->GetActorRotation());
+	ProjectileMovementComp->Velocity = Predicted->ProjectileMovementComp->Velocity;
+
+	Predicted->Destroy();
 }
 
 // Called when the game starts or when spawned
 void ASProjectileBase::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	if (IsPredicted()) {
+		INC_DWORD_STAT(STAT_ActionRoguelike_PredictedProjectiles);
+	}
+	else if (GetNetMode() != NM_Standalone) {
+		INC_DWORD_STAT(STAT_ActionRoguelike_ReplicatedProjectiles);
+	}
+
+	// the server's copy of a projectile this client predicted, hand the local copy over to it
+	if (PredictionId != 0 && GetLocalRole() == ROLE_SimulatedProxy) {
+		ASCharacter* Character = Cast<ASCharacter>(GetInstigator());
+		if (Character && Character->IsLocallyControlled()) {
+			Character->ReconcileProjectile(this);
+		}
+	}
+}
+
+void ASProjectileBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (IsPredicted()) {
+		DEC_DWORD_STAT(STAT_ActionRoguelike_PredictedProjectiles);
+	}
+	else if (GetNetMode() != NM_Standalone) {
+		DEC_DWORD_STAT(STAT_ActionRoguelike_ReplicatedProjectiles);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -43,3 +99,9 @@ void ASProjectileBase::Tick(float DeltaTime)
 
 }
 
+void ASProjectileBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(ASProjectileBase, PredictionId, COND_InitialOnly);
+}
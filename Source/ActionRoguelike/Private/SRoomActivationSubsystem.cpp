@@ -0,0 +1,337 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SRoomActivationSubsystem.h"
+#include "ActionRoguelike.h"
+#include "Gateway.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("RoomActivation Update"), STAT_RoomActivationUpdate, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Rooms"), STAT_ActiveRooms, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant Rooms"), STAT_DormantRooms, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Room Actors"), STAT_ActiveRoomActors, STATGROUP_ActionRoguelike);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant Room Actors"), STAT_DormantRoomActors, STATGROUP_ActionRoguelike);
+
+// reason the brains of dormant ai are paused with
+static const TCHAR* DormantReason = TEXT("RoomDormant");
+
+bool USRoomActivationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USRoomActivationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (ULevel* Level : InWorld.GetLevels()) {
+		OnLevelAdded(Level, &InWorld);
+	}
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &USRoomActivationSubsystem::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &USRoomActivationSubsystem::OnLevelRemoved);
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &USRoomActivationSubsystem::OnActorSpawned));
+}
+
+void USRoomActivationSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	if (ActorSpawnedHandle.IsValid()) {
+		GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	Rooms.Empty();
+	GatewayCells.Empty();
+	PendingActors.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId USRoomActivationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USRoomActivationSubsystem, STATGROUP_Tickables);
+}
+
+bool USRoomActivationSubsystem::IsActorDormant(const AActor* Actor) const
+{
+	const FRoom* Room = Actor ? Rooms.Find(Actor->GetLevel()) : nullptr;
+	return Room && !Room->bActive;
+}
+
+void USRoomActivationSubsystem::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (Level == nullptr || World != GetWorld() || Level->IsPersistentLevel()) return;
+
+	// only levels with gateways are rooms
+	FRoom Room;
+	for (AActor* Actor : Level->Actors) {
+		if (const AGateway* Gateway = Cast<AGateway>(Actor)) {
+			Room.Gateways.Add(Gateway->GetActorLocation());
+		}
+	}
+	if (Room.Gateways.Num() == 0) return;
+
+	for (AActor* Actor : Level->Actors) {
+		if (Actor == nullptr || Actor->IsA<AGateway>()) continue;
+
+		if (Actor->IsLevelBoundsRelevant()) {
+			Room.Bounds += Actor->GetComponentsBoundingBox();
+		}
+		AddActor(Room, Actor);
+	}
+	for (const FVector& Gateway : Room.Gateways) {
+		Room.Bounds += Gateway;
+	}
+
+	// new rooms start asleep, the next update wakes them if a player is close
+	FRoom& AddedRoom = Rooms.Add(Level, MoveTemp(Room));
+	SetRoomActive(AddedRoom, false);
+	RebuildGatewayCells();
+	TimeSinceUpdate = UpdateInterval;
+}
+
+void USRoomActivationSubsystem::OnLevelRemoved(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld()) return;
+
+	// a null level means all levels were removed
+	if (Level == nullptr) {
+		Rooms.Empty();
+		GatewayCells.Empty();
+	}
+	else if (Rooms.Remove(Level) > 0) {
+		RebuildGatewayCells();
+	}
+	UpdateStats();
+}
+
+void USRoomActivationSubsystem::OnActorSpawned(AActor* Actor)
+{
+	// runtime spawns in a room, like the replacements of the dungeon generator
+	if (!Rooms.Contains(Actor->GetLevel())) return;
+
+	if (!Actor->IsActorInitialized() || !Actor->HasActorBegunPlay()) {
+		PendingActors.Add(Actor);
+		return;
+	}
+	AddActor(Rooms[Actor->GetLevel()], Actor);
+}
+
+void USRoomActivationSubsystem::AddPendingActors()
+{
+	for (int32 Index = 0; Index < PendingActors.Num(); Index++) {
+		AActor* Actor = PendingActors[Index].Get();
+		if (Actor && (!Actor->IsActorInitialized() || !Actor->HasActorBegunPlay())) continue;
+
+		PendingActors.RemoveAtSwap(Index--);
+		if (Actor == nullptr) continue;
+
+		if (FRoom* Room = Rooms.Find(Actor->GetLevel())) {
+			AddActor(*Room, Actor);
+		}
+	}
+}
+
+void USRoomActivationSubsystem::AddActor(FRoom& Room, AActor* Actor)
+{
+	// controllers are managed through their pawn
+	if (Actor->IsA<AController>()) return;
+
+	// actors without tick, physics or ai have nothing to put to sleep
+	const APawn* Pawn = Cast<APawn>(Actor);
+	const UPrimitiveComponent* Root = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+	if (!Actor->PrimaryActorTick.bCanEverTick && !Pawn && !(Root && Root->IsSimulatingPhysics())) return;
+
+	FManagedActor& Managed = Room.Actors.AddDefaulted_GetRef();
+	Managed.Actor = Actor;
+	if (!Room.bActive) {
+		SleepActor(Managed);
+	}
+
+	if (Pawn && Pawn->GetController() && !Pawn->IsPlayerControlled()) {
+		FManagedActor& ManagedController = Room.Actors.AddDefaulted_GetRef();
+		ManagedController.Actor = Pawn->GetController();
+		if (!Room.bActive) {
+			SleepActor(ManagedController);
+		}
+	}
+}
+
+void USRoomActivationSubsystem::SleepActor(FManagedActor& Managed)
+{
+	AActor* Actor = Managed.Actor.Get();
+	if (Actor == nullptr) return;
+
+	Managed.bTickWasEnabled = Actor->IsActorTickEnabled();
+	Actor->SetActorTickEnabled(false);
+
+	Managed.TickingComponents.Reset();
+	for (UActorComponent* Component : Actor->GetComponents()) {
+		if (Component == nullptr) continue;
+
+		if (Component->IsComponentTickEnabled()) {
+			Managed.TickingComponents.Add(Component);
+			Component->SetComponentTickEnabled(false);
+		}
+
+		UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+		if (Primitive && Primitive->IsSimulatingPhysics()) {
+			Primitive->PutRigidBodyToSleep();
+		}
+	}
+
+	if (AAIController* Controller = Cast<AAIController>(Actor)) {
+		if (UBrainComponent* Brain = Controller->GetBrainComponent()) {
+			Brain->PauseLogic(DormantReason);
+		}
+	}
+}
+
+void USRoomActivationSubsystem::WakeActor(FManagedActor& Managed)
+{
+	AActor* Actor = Managed.Actor.Get();
+	if (Actor == nullptr) return;
+
+	Actor->SetActorTickEnabled(Managed.bTickWasEnabled);
+	for (const TWeakObjectPtr<UActorComponent>& Component : Managed.TickingComponents) {
+		if (Component.IsValid()) {
+			Component->SetComponentTickEnabled(true);
+		}
+	}
+	Managed.TickingComponents.Reset();
+
+	if (AAIController* Controller = Cast<AAIController>(Actor)) {
+		if (UBrainComponent* Brain = Controller->GetBrainComponent()) {
+			Brain->ResumeLogic(DormantReason);
+		}
+	}
+
+	// sleeping bodies stay asleep until something touches them, nothing to simulate until then
+}
+
+void USRoomActivationSubsystem::SetRoomActive(FRoom& Room, bool bActive)
+{
+	if (Room.bActive == bActive) return;
+	Room.bActive = bActive;
+
+	Room.Actors.RemoveAllSwap([](const FManagedActor& Managed) { return !Managed.Actor.IsValid(); });
+	for (FManagedActor& Managed : Room.Actors) {
+		if (bActive) {
+			WakeActor(Managed);
+		}
+		else {
+			SleepActor(Managed);
+		}
+	}
+}
+
+FIntVector USRoomActivationSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void USRoomActivationSubsystem::RebuildGatewayCells()
+{
+	GatewayCells.Reset();
+	for (const TPair<TObjectKey<ULevel>, FRoom>& Pair : Rooms) {
+		for (const FVector& Gateway : Pair.Value.Gateways) {
+			GatewayCells.AddUnique(GetCell(Gateway), Pair.Key);
+		}
+	}
+}
+
+void USRoomActivationSubsystem::Tick(float DeltaTime)
+{
+	// every frame, a finished spawn in a dormant room shouldn't stay awake until the next update
+	if (PendingActors.Num() > 0) {
+		AddPendingActors();
+	}
+
+	TimeSinceUpdate += DeltaTime;
+	if (Rooms.Num() == 0 || TimeSinceUpdate < UpdateInterval) return;
+	TimeSinceUpdate = 0.0f;
+
+	UpdateActivation();
+}
+
+void USRoomActivationSubsystem::UpdateActivation()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RoomActivationUpdate);
+
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It) {
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->GetPawn()) {
+			PlayerLocations.Add(PlayerController->GetPawn()->GetActorLocation());
+		}
+	}
+
+	// rooms with a gateway in wake radius of a player, looked up in the cells around each player
+	TSet<TObjectKey<ULevel>> WokenRooms;
+	const int32 CellRadius = FMath::CeilToInt(WakeRadius / CellSize);
+	for (const FVector& PlayerLocation : PlayerLocations) {
+		const FIntVector PlayerCell = GetCell(PlayerLocation);
+		for (int32 X = -CellRadius; X <= CellRadius; X++) {
+			for (int32 Y = -CellRadius; Y <= CellRadius; Y++) {
+				for (int32 Z = -CellRadius; Z <= CellRadius; Z++) {
+					for (auto It = GatewayCells.CreateConstKeyIterator(PlayerCell + FIntVector(X, Y, Z)); It; ++It) {
+						WokenRooms.Add(It.Value());
+					}
+				}
+			}
+		}
+	}
+
+	for (TPair<TObjectKey<ULevel>, FRoom>& Pair : Rooms) {
+		FRoom& Room = Pair.Value;
+
+		bool bWake = false;
+		bool bKeepAwake = false;
+		for (const FVector& PlayerLocation : PlayerLocations) {
+			if (Room.Bounds.IsInsideOrOn(PlayerLocation)) {
+				bWake = true;
+				break;
+			}
+
+			const bool bNearCell = WokenRooms.Contains(Pair.Key);
+			for (const FVector& Gateway : Room.Gateways) {
+				const double DistanceSquared = FVector::DistSquared(PlayerLocation, Gateway);
+				bWake |= bNearCell && DistanceSquared <= FMath::Square(WakeRadius);
+				bKeepAwake |= DistanceSquared <= FMath::Square(SleepRadius);
+			}
+			bKeepAwake |= Room.Bounds.ComputeSquaredDistanceToPoint(PlayerLocation) <= FMath::Square(SleepRadius - WakeRadius);
+		}
+
+		if (!Room.bActive && bWake) {
+			SetRoomActive(Room, true);
+		}
+		else if (Room.bActive && !bWake && !bKeepAwake) {
+			SetRoomActive(Room, false);
+		}
+	}
+
+	UpdateStats();
+}
+
+void USRoomActivationSubsystem::UpdateStats()
+{
+	int32 NumActiveActors = 0;
+	int32 NumDormantActors = 0;
+	NumActiveRooms = 0;
+	for (const TPair<TObjectKey<ULevel>, FRoom>& Pair : Rooms) {
+		NumActiveRooms += Pair.Value.bActive;
+		(Pair.Value.bActive ? NumActiveActors : NumDormantActors) += Pair.Value.Actors.Num();
+	}
+
+	SET_DWORD_STAT(STAT_ActiveRooms, NumActiveRooms);
+	SET_DWORD_STAT(STAT_DormantRooms, Rooms.Num() - NumActiveRooms);
+	SET_DWORD_STAT(STAT_ActiveRoomActors, NumActiveActors);
+	SET_DWORD_STAT(STAT_DormantRoomActors, NumDormantActors);
+}
@@ -0,0 +1,462 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SSaveGameSubsystem.h"
+#include "ActionRoguelike.h"
+#include "SSavableInterface.h"
+#include "DungeonGenerationSubsystem.h"
+#include "GeneratorSelection.h"
+#include "Async/Async.h"
+#include "Engine/Level.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("SaveGame Capture"), STAT_SaveGameCapture, STATGROUP_ActionRoguelike);
+DECLARE_CYCLE_STAT(TEXT("SaveGame Write"), STAT_SaveGameWrite, STATGROUP_ActionRoguelike);
+DECLARE_CYCLE_STAT(TEXT("SaveGame Read"), STAT_SaveGameRead, STATGROUP_ActionRoguelike);
+DECLARE_CYCLE_STAT(TEXT("SaveGame Restore"), STAT_SaveGameRestore, STATGROUP_ActionRoguelike);
+
+FArchive& operator<<(FArchive& Ar, FSSaveSnapshot& Snapshot)
+{
+	uint32 Magic = FSSaveSnapshot::MagicNumber;
+	Snapshot.Version = Ar.IsSaving() ? FSSaveSnapshot::CurrentVersion : Snapshot.Version;
+
+	Ar << Magic << Snapshot.Version;
+
+	if (Ar.IsLoading() && (Magic != FSSaveSnapshot::MagicNumber || Snapshot.Version > FSSaveSnapshot::CurrentVersion)) {
+		Ar.SetError();
+		return Ar;
+	}
+
+	Ar << Snapshot.bHasManifest;
+	if (Snapshot.bHasManifest) {
+		Ar << Snapshot.Manifest;
+	}
+	Ar << Snapshot.Actors;
+
+	return Ar;
+}
+
+static void SaveObjectState(UObject* Object, TArray<uint8>& OutState)
+{
+	FMemoryWriter Writer(OutState, true);
+	CastChecked<ISSavableInterface>(Object)->SerializeSaveState(Writer, FSSaveSnapshot::CurrentVersion);
+}
+
+static void LoadObjectState(UObject* Object, const TArray<uint8>& State, int32 Version)
+{
+	if (State.Num() == 0) return;
+
+	FMemoryReader Reader(State, true);
+	CastChecked<ISSavableInterface>(Object)->SerializeSaveState(Reader, Version);
+}
+
+bool USSaveGameSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USSaveGameSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (ULevel* Level : InWorld.GetLevels()) {
+		OnLevelAdded(Level, &InWorld);
+	}
+
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &USSaveGameSubsystem::OnActorSpawned));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &USSaveGameSubsystem::OnLevelAdded);
+}
+
+void USSaveGameSubsystem::Deinitialize()
+{
+	if (ActorSpawnedHandle.IsValid()) {
+		GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	SavableActors.Empty();
+	PendingSnapshot.Reset();
+
+	Super::Deinitialize();
+}
+
+bool USSaveGameSubsystem::IsSavable(const AActor* Actor)
+{
+	if (Actor == nullptr || Actor->IsPendingKillPending()) return false;
+	if (Actor->Implements<USSavableInterface>()) return true;
+
+	for (const UActorComponent* Component : Actor->GetComponents()) {
+		if (Component && Component->Implements<USSavableInterface>()) return true;
+	}
+	return false;
+}
+
+void USSaveGameSubsystem::RegisterActor(AActor* Actor, bool bPlaced)
+{
+	if (IsSavable(Actor)) {
+		SavableActors.Add(Actor, bPlaced);
+	}
+}
+
+void USSaveGameSubsystem::OnActorSpawned(AActor* Actor)
+{
+	RegisterActor(Actor, false);
+}
+
+void USSaveGameSubsystem::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (Level == nullptr || World != GetWorld()) return;
+
+	// everything in a level when it is added was placed there, runtime spawns go through OnActorSpawned
+	for (AActor* Actor : Level->Actors) {
+		RegisterActor(Actor, true);
+	}
+}
+
+TMap<const ULevel*, FManifestLevelRef> USSaveGameSubsystem::MakeLoadedLevelRefs() const
+{
+	UWorld* World = GetWorld();
+
+	TMap<const ULevel*, FManifestLevelRef> LevelRefs;
+	LevelRefs.Add(World->PersistentLevel, FManifestLevelRef());
+	for (const TPair<const ULevelStreaming*, FManifestLevelRef>& Pair : GeneratorSelection::MakeLevelRefs(World)) {
+		if (const ULevel* Level = Pair.Key->GetLoadedLevel()) {
+			LevelRefs.Add(Level, Pair.Value);
+		}
+	}
+	return LevelRefs;
+}
+
+bool USSaveGameSubsystem::MakeKey(const AActor* Actor, bool bPlaced, const TMap<const ULevel*, FManifestLevelRef>& LevelRefs,
+	const TMap<const APawn*, int32>& PlayerPawns, FSSaveKey& OutKey) const
+{
+	const UDungeonGenerationSubsystem* DungeonGeneration = GetWorld()->GetSubsystem<UDungeonGenerationSubsystem>();
+	if (DungeonGeneration && DungeonGeneration->GetSpawnedActorSource(Actor, OutKey.Level, OutKey.Name)) {
+		OutKey.Type = ESSaveKeyType::Generated;
+		return true;
+	}
+
+	if (const int32* PlayerIndex = PlayerPawns.Find(Cast<APawn>(Actor))) {
+		OutKey.Type = ESSaveKeyType::Player;
+		OutKey.Index = *PlayerIndex;
+		return true;
+	}
+
+	const FManifestLevelRef* LevelRef = LevelRefs.Find(Actor->GetLevel());
+	if (LevelRef == nullptr) return false;
+
+	OutKey.Type = bPlaced ? ESSaveKeyType::Placed : ESSaveKeyType::Spawned;
+	OutKey.Level = *LevelRef;
+	OutKey.Name = bPlaced ? Actor->GetFName() : NAME_None;
+	return true;
+}
+
+static TMap<const APawn*, int32> MakePlayerPawns(UWorld* World)
+{
+	TMap<const APawn*, int32> PlayerPawns;
+	int32 PlayerIndex = 0;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It, PlayerIndex++) {
+		if (const APlayerController* PlayerController = It->Get()) {
+			if (const APawn* Pawn = PlayerController->GetPawn()) {
+				PlayerPawns.Add(Pawn, PlayerIndex);
+			}
+		}
+	}
+	return PlayerPawns;
+}
+
+void USSaveGameSubsystem::CaptureSnapshot(FSSaveSnapshot& OutSnapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SaveGameCapture);
+
+	UWorld* World = GetWorld();
+
+	OutSnapshot = FSSaveSnapshot();
+	if (const UDungeonGenerationSubsystem* DungeonGeneration = World->GetSubsystem<UDungeonGenerationSubsystem>()) {
+		const FGenerationManifest& Manifest = DungeonGeneration->GetManifest();
+		OutSnapshot.bHasManifest = Manifest.Levels.Num() > 0 || Manifest.Actors.Num() > 0;
+		OutSnapshot.Manifest = Manifest;
+	}
+
+	const TMap<const ULevel*, FManifestLevelRef> LevelRefs = MakeLoadedLevelRefs();
+	const TMap<const APawn*, int32> PlayerPawns = MakePlayerPawns(World);
+
+	OutSnapshot.Actors.Reserve(SavableActors.Num());
+	for (auto It = SavableActors.CreateIterator(); It; ++It) {
+		AActor* Actor = It->Key.Get();
+		if (Actor == nullptr || Actor->IsPendingKillPending()) {
+			It.RemoveCurrent();
+			continue;
+		}
+
+		FSActorRecord& Record = OutSnapshot.Actors.AddDefaulted_GetRef();
+		if (!MakeKey(Actor, It->Value, LevelRefs, PlayerPawns, Record.Key)) {
+			OutSnapshot.Actors.Pop(false);
+			continue;
+		}
+
+		Record.ClassPath = Actor->GetClass()->GetPathName();
+		Record.Transform = Actor->GetActorTransform();
+
+		if (Actor->Implements<USSavableInterface>()) {
+			SaveObjectState(Actor, Record.ActorState);
+		}
+		for (UActorComponent* Component : Actor->GetComponents()) {
+			if (Component && Component->Implements<USSavableInterface>()) {
+				TPair<FName, TArray<uint8>>& ComponentState = Record.ComponentStates.AddDefaulted_GetRef();
+				ComponentState.Key = Component->GetFName();
+				SaveObjectState(Component, ComponentState.Value);
+			}
+		}
+	}
+}
+
+int32 USSaveGameSubsystem::RestoreActors(const FSSaveSnapshot& Snapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SaveGameRestore);
+
+	UWorld* World = GetWorld();
+
+	// find the existing actors by their keys
+	const TMap<const ULevel*, FManifestLevelRef> LevelRefs = MakeLoadedLevelRefs();
+	const TMap<const APawn*, int32> PlayerPawns = MakePlayerPawns(World);
+
+	TMap<FSSaveKey, AActor*> ExistingActors;
+	ExistingActors.Reserve(SavableActors.Num());
+	for (const TPair<TWeakObjectPtr<AActor>, bool>& Pair : SavableActors) {
+		AActor* Actor = Pair.Key.Get();
+		FSSaveKey Key;
+		if (Actor && !Actor->IsPendingKillPending() && MakeKey(Actor, Pair.Value, LevelRefs, PlayerPawns, Key) && Key.Type != ESSaveKeyType::Spawned) {
+			ExistingActors.Add(Key, Actor);
+		}
+	}
+
+	// runtime actors of the current run are replaced by the saved ones
+	for (const TPair<TWeakObjectPtr<AActor>, bool>& Pair : SavableActors) {
+		AActor* Actor = Pair.Key.Get();
+		FSSaveKey Key;
+		if (Actor && !Pair.Value && MakeKey(Actor, false, LevelRefs, PlayerPawns, Key) && Key.Type == ESSaveKeyType::Spawned) {
+			Actor->Destroy();
+		}
+	}
+
+	auto ApplyState = [&Snapshot](AActor* Actor, const FSActorRecord& Record)
+	{
+		if (Actor->Implements<USSavableInterface>()) {
+			LoadObjectState(Actor, Record.ActorState, Snapshot.Version);
+		}
+		for (const TPair<FName, TArray<uint8>>& ComponentState : Record.ComponentStates) {
+			UActorComponent* Component = FindObjectFast<UActorComponent>(Actor, ComponentState.Key);
+			if (Component && Component->Implements<USSavableInterface>()) {
+				LoadObjectState(Component, ComponentState.Value, Snapshot.Version);
+			}
+		}
+	};
+
+	// spawn the missing runtime actors deferred: state first, BeginPlay once the whole batch is in place
+	TArray<TPair<AActor*, const FSActorRecord*>> DeferredActors;
+	int32 NumRestored = 0;
+
+	for (const FSActorRecord& Record : Snapshot.Actors) {
+		if (Record.Key.Type == ESSaveKeyType::Spawned) {
+			UClass* ActorClass = TSoftClassPtr<AActor>(FSoftObjectPath(Record.ClassPath)).LoadSynchronous();
+			ULevelStreaming* LevelStream = Record.Key.Level.PackageKey != NAME_None ? GeneratorSelection::ResolveLevelRef(World, Record.Key.Level) : nullptr;
+
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.bDeferConstruction = true;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			SpawnParams.OverrideLevel = LevelStream ? LevelStream->GetLoadedLevel() : nullptr;
+
+			AActor* Actor = ActorClass ? World->SpawnActor(ActorClass, &Record.Transform, SpawnParams) : nullptr;
+			if (Actor) {
+				ApplyState(Actor, Record);
+				DeferredActors.Emplace(Actor, &Record);
+			}
+			continue;
+		}
+
+		AActor* const* Actor = ExistingActors.Find(Record.Key);
+		if (Actor == nullptr) continue;
+
+		// players resume where they saved, placed and generated actors don't move
+		if (Record.Key.Type == ESSaveKeyType::Player) {
+			(*Actor)->SetActorTransform(Record.Transform, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+		ApplyState(*Actor, Record);
+		NumRestored++;
+	}
+
+	for (const TPair<AActor*, const FSActorRecord*>& Deferred : DeferredActors) {
+		Deferred.Key->FinishSpawning(Deferred.Value->Transform);
+		NumRestored++;
+	}
+
+	return NumRestored;
+}
+
+bool USSaveGameSubsystem::WriteSnapshot(FSSaveSnapshot& Snapshot, TArray<uint8>& OutBytes)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SaveGameWrite);
+
+	TArray<uint8> RawBytes;
+	FMemoryWriter RawWriter(RawBytes, true);
+	RawWriter << Snapshot;
+
+	// header stays uncompressed, so a reader can check magic and size before inflating
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, RawBytes.Num());
+	TArray<uint8> CompressedBytes;
+	CompressedBytes.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Oodle, CompressedBytes.GetData(), CompressedSize, RawBytes.GetData(), RawBytes.Num())) {
+		return false;
+	}
+	CompressedBytes.SetNum(CompressedSize, false);
+
+	uint32 Magic = FSSaveSnapshot::MagicNumber;
+	int32 UncompressedSize = RawBytes.Num();
+
+	OutBytes.Reset();
+	FMemoryWriter Writer(OutBytes, true);
+	Writer << Magic << UncompressedSize << CompressedBytes;
+	return !Writer.IsError();
+}
+
+bool USSaveGameSubsystem::ReadSnapshot(const TArray<uint8>& Bytes, FSSaveSnapshot& OutSnapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SaveGameRead);
+
+	uint32 Magic = 0;
+	int32 UncompressedSize = 0;
+	TArray<uint8> CompressedBytes;
+
+	FMemoryReader Reader(Bytes, true);
+	Reader << Magic << UncompressedSize;
+	if (Reader.IsError() || Magic != FSSaveSnapshot::MagicNumber) return false;
+	if (UncompressedSize <= 0 || UncompressedSize > FSSaveSnapshot::MaxUncompressedSize) return false;
+
+	Reader << CompressedBytes;
+	if (Reader.IsError()) return false;
+
+	TArray<uint8> RawBytes;
+	RawBytes.SetNumUninitialized(UncompressedSize);
+	if (!FCompression::UncompressMemory(NAME_Oodle, RawBytes.GetData(), UncompressedSize, CompressedBytes.GetData(), CompressedBytes.Num())) {
+		return false;
+	}
+
+	FMemoryReader RawReader(RawBytes, true);
+	RawReader << OutSnapshot;
+	return !RawReader.IsError();
+}
+
+FString USSaveGameSubsystem::GetSlotPath(const FString& SlotName)
+{
+	return FPaths::ProjectSavedDir() / TEXT("SaveGames") / SlotName + TEXT(".arsav");
+}
+
+bool USSaveGameSubsystem::SaveGame(const FString& SlotName)
+{
+	if (IsBusy()) return false;
+	bSaving = true;
+
+	const double StartTime = FPlatformTime::Seconds();
+	TSharedPtr<FSSaveSnapshot> Snapshot = MakeShared<FSSaveSnapshot>();
+	CaptureSnapshot(*Snapshot);
+	const double CaptureSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TWeakObjectPtr<USSaveGameSubsystem> WeakThis(this);
+	const FString FilePath = GetSlotPath(SlotName);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Snapshot, SlotName, FilePath, StartTime, CaptureSeconds]()
+	{
+		TArray<uint8> Bytes;
+		const bool bSuccess = WriteSnapshot(*Snapshot, Bytes) && FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+
+		UE_LOG(LogActionRoguelike, Log, TEXT("Saved %d actors to '%s' (%d bytes): capture %.2f ms on the game thread, %.2f ms total"),
+			Snapshot->Actors.Num(), *FilePath, Bytes.Num(), CaptureSeconds * 1000.0, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SlotName, bSuccess]()
+		{
+			USSaveGameSubsystem* This = WeakThis.Get();
+			if (This == nullptr) return;
+
+			This->bSaving = false;
+			This->OnGameSaved.Broadcast(SlotName, bSuccess);
+		});
+	});
+
+	return true;
+}
+
+bool USSaveGameSubsystem::LoadGame(const FString& SlotName)
+{
+	if (IsBusy()) return false;
+	bLoading = true;
+
+	TWeakObjectPtr<USSaveGameSubsystem> WeakThis(this);
+	const FString FilePath = GetSlotPath(SlotName);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, SlotName, FilePath]()
+	{
+		TSharedPtr<FSSaveSnapshot> Snapshot = MakeShared<FSSaveSnapshot>();
+		TArray<uint8> Bytes;
+		if (!FFileHelper::LoadFileToArray(Bytes, *FilePath) || !ReadSnapshot(Bytes, *Snapshot)) {
+			UE_LOG(LogActionRoguelike, Warning, TEXT("Failed to read save game '%s'!"), *FilePath);
+			Snapshot.Reset();
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SlotName, Snapshot]()
+		{
+			if (USSaveGameSubsystem* This = WeakThis.Get()) {
+				This->OnSnapshotRead(SlotName, Snapshot);
+			}
+		});
+	});
+
+	return true;
+}
+
+void USSaveGameSubsystem::OnSnapshotRead(const FString& SlotName, TSharedPtr<FSSaveSnapshot> Snapshot)
+{
+	PendingSlotName = SlotName;
+	if (!Snapshot.IsValid()) {
+		FinishLoad(false);
+		return;
+	}
+
+	// the generated rooms and actors have to exist before their state can be applied
+	UDungeonGenerationSubsystem* DungeonGeneration = GetWorld()->GetSubsystem<UDungeonGenerationSubsystem>();
+	if (Snapshot->bHasManifest && DungeonGeneration && DungeonGeneration->GenerateFromManifest(Snapshot->Manifest)) {
+		PendingSnapshot = Snapshot;
+		DungeonGeneration->OnDungeonGenerated.AddUniqueDynamic(this, &USSaveGameSubsystem::OnDungeonRestored);
+		return;
+	}
+
+	const int32 NumRestored = RestoreActors(*Snapshot);
+	UE_LOG(LogActionRoguelike, Log, TEXT("Restored %d of %d saved actors"), NumRestored, Snapshot->Actors.Num());
+	FinishLoad(true);
+}
+
+void USSaveGameSubsystem::OnDungeonRestored(const FDungeonGenerationStats& Stats)
+{
+	if (UDungeonGenerationSubsystem* DungeonGeneration = GetWorld()->GetSubsystem<UDungeonGenerationSubsystem>()) {
+		DungeonGeneration->OnDungeonGenerated.RemoveDynamic(this, &USSaveGameSubsystem::OnDungeonRestored);
+	}
+
+	TSharedPtr<FSSaveSnapshot> Snapshot = MoveTemp(PendingSnapshot);
+	if (!Snapshot.IsValid()) return;
+
+	const int32 NumRestored = RestoreActors(*Snapshot);
+	UE_LOG(LogActionRoguelike, Log, TEXT("Restored %d of %d saved actors"), NumRestored, Snapshot->Actors.Num());
+	FinishLoad(true);
+}
+
+void USSaveGameSubsystem::FinishLoad(bool bSuccess)
+{
+	bLoading = false;
+	OnGameLoaded.Broadcast(PendingSlotName, bSuccess);
+}
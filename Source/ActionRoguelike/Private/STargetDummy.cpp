@@ -5,6 +5,7 @@
 
 #include "Components/StaticMeshComponent.h"
 #include "SAttributeComponent.h"
+#include "SHitFlashComponent.h"
 
 // Sets default values
 ASTargetDummy::ASTargetDummy()
@@ -17,11 +18,16 @@ ASTargetDummy::ASTargetDummy()
 
 	AttributeComp = CreateDefaultSubobject<USAttributeComponent>("AttributeComp");
 	AttributeComp->OnHealthChanged.AddDynamic(this, &ASTargetDummy::OnHealthChange);
+
+	HitFlashComp = CreateDefaultSubobject<USHitFlashComponent>("HitFlashComp");
+	HitFlashComp->SetFlashMesh(MeshComp);
+	// the dummy material has its own flash color, it only ever got TimeToHit
+	HitFlashComp->bWriteFlashColor = false;
 }
 
 void ASTargetDummy::OnHealthChange(AActor* InstigatorActor, USAttributeComponent* OwningComp, float NewHealth, float Delta)
 {
 	if(Delta < 0.0f)
-		MeshComp->SetScalarParameterValueOnMaterials("TimeToHit", GetWorld()->TimeSeconds);
+		HitFlashComp->Flash();
 }
 
@@ -27,6 +27,9 @@ void ASTeleportProjectile::Teleport()
 
 	UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ParticleSystem, SpawnTM);
 
-	GetInstigator()->SetActorLocation(GetActorLocation());
+	// predicted and remote copies only play the effect, the server moves the character
+	if (HasGameplayAuthority()) {
+		GetInstigator()->SetActorLocation(GetActorLocation());
+	}
 	Destroy();
 }
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SAreaEffectSubsystem.generated.h"
+
+class UPrimitiveComponent;
+
+// radial impulse and damage around a point
+struct FSAreaEffect
+{
+	FVector Location = FVector::ZeroVector;
+	float Radius = 0.0f;
+
+	float ImpulseStrength = 0.0f;
+	ERadialImpulseFalloff Falloff = RIF_Constant;
+	bool bVelChange = false;
+
+	// damage to every actor with attributes in the radius, scaled down to the edge with RIF_Linear
+	float Damage = 0.0f;
+
+	// actor the effect doesn't damage, usually the one that caused it
+	TWeakObjectPtr<AActor> IgnoredActor;
+};
+
+// Applies area effects with one overlap query per effect, or per group of effects, and one pass over its results
+// that applies impulses and damage together. Attribute components come from the attribute registry.
+UCLASS()
+class ACTIONROGUELIKE_API USAreaEffectSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// apply one effect, returns the number of affected bodies and actors
+	int32 ApplyAreaEffect(const FSAreaEffect& Effect);
+
+	// apply effects that lie within the sphere at Center with a single overlap of that sphere
+	int32 ApplyAreaEffects(TConstArrayView<FSAreaEffect> Effects, const FVector& Center, float Radius);
+
+	// add a radial force to bodies the caller already knows are in range, no overlap query, for effects that track
+	// the bodies around them. negative Strength pulls, returns the number of pushed bodies
+	int32 ApplyRadialForce(TConstArrayView<UPrimitiveComponent*> Bodies, const FVector& Origin, float Radius, float Strength, ERadialImpulseFalloff Falloff, bool bAccelChange);
+
+	// UWorldSubsystem
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+};
@@ -4,12 +4,41 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "SSavableInterface.h"
 #include "SAttributeComponent.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnHealthChanged, AActor*, InstigatorActor, USAttributeComponent*, OwningComp, float, Health, float, Delta);
 
+// health and max health as they go over the wire: tenths of a point in packed ints, a few bytes instead of two floats
+USTRUCT()
+struct ACTIONROGUELIKE_API FSQuantizedHealth
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float Health = 0.0f;
+
+	UPROPERTY()
+	float MaxHealth = 0.0f;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FSQuantizedHealth& Other) const { return Health == Other.Health && MaxHealth == Other.MaxHealth; }
+	bool operator!=(const FSQuantizedHealth& Other) const { return !(*this == Other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FSQuantizedHealth> : public TStructOpsTypeTraitsBase2<FSQuantizedHealth>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
-class ACTIONROGUELIKE_API USAttributeComponent : public UActorComponent
+class ACTIONROGUELIKE_API USAttributeComponent : public UActorComponent, public ISSavableInterface
 {
 	GENERATED_BODY()
 
@@ -17,6 +46,9 @@ public:
 	// Sets default values for this component's properties
 	USAttributeComponent();
 
+	// attribute component of an actor from the registry the components add themselves to, no component search
+	static USAttributeComponent* GetAttributes(const AActor* Actor);
+
 protected:
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Attributes")
@@ -25,6 +57,19 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Attributes")
 	float MaxHealth;
 
+	// push based, only compared and sent after ApplyHealthChange marked it dirty
+	UPROPERTY(ReplicatedUsing = OnRep_Health)
+	FSQuantizedHealth ReplicatedHealth;
+
+	// clients only see the replicated value, so the change event is raised from here
+	UFUNCTION()
+	void OnRep_Health(const FSQuantizedHealth& OldHealth);
+
+	virtual void PostInitProperties() override;
+
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
 public:	
 
 	UPROPERTY(BlueprintAssignable)
@@ -38,4 +83,9 @@ public:
 
 	bool IsMaxHealth();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// ISSavableInterface
+	virtual void SerializeSaveState(FArchive& Ar, int32 Version) override;
+
 };
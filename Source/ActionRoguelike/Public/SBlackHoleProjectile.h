@@ -6,12 +6,57 @@
 #include "SProjectileBase.h"
 #include "SBlackHoleProjectile.generated.h"
 
-/**
- * 
- */
+class FPhysScene_Chaos;
+
+// Pulls physics bodies towards it. The bodies in range are tracked as they enter and leave the influence sphere
+// instead of queried each frame, and their forces are added in one pass through the area effect subsystem right
+// before the physics scene steps. Bodies without overlap events (most physics props) are found by one overlap query
+// when play starts and every RefreshInterval. A radial force component the blueprint still has is removed when play
+// starts, the native pull covers its bodies.
 UCLASS()
 class ACTIONROGUELIKE_API ASBlackHoleProjectile : public ASProjectileBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	ASBlackHoleProjectile();
+
+	int32 GetNumInfluencedBodies() const { return InfluencedBodies.Num(); }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UPROPERTY(VisibleAnywhere)
+	USphereComponent* InfluenceComp;
+
+	// acceleration towards the center at the center, fading out linearly to the edge of the influence sphere
+	UPROPERTY(EditAnywhere, Category = "BlackHole")
+	float PullStrength = 2000.0f;
+
+	// bodies past this many are left alone until one of the pulled bodies leaves
+	UPROPERTY(EditAnywhere, Category = "BlackHole")
+	int32 MaxInfluencedBodies = 32;
+
+	// seconds between overlap queries that pick up bodies the overlap events miss
+	UPROPERTY(EditAnywhere, Category = "BlackHole")
+	float RefreshInterval = 0.25f;
+
+	UFUNCTION()
+	void OnInfluenceBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnInfluenceEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	void ApplyForces(FPhysScene_Chaos* PhysScene, float DeltaTime);
+
+	// query the simulating bodies in the influence sphere, the ones still in range keep their place in the order
+	void RefreshInfluencedBodies();
+
+	FTimerHandle RefreshTimerHandle;
+
+	// simulating bodies inside the influence sphere, pulled in the order they entered up to MaxInfluencedBodies
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> InfluencedBodies;
+
+	FDelegateHandle PhysScenePreTickHandle;
 };
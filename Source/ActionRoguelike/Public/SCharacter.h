@@ -11,6 +11,8 @@ class UCameraComponent;
 class USInteractionComponent;
 class UAnimMontage;
 class USAttributeComponent;
+class USHitFlashComponent;
+class ASProjectileBase;
 
 UCLASS()
 class ACTIONROGUELIKE_API ASCharacter : public ACharacter
@@ -23,16 +25,40 @@ public:
 	// Sets default values for this character's properties
 	ASCharacter();
 
+	// called by the replicated copy of a projectile this client predicted
+	void ReconcileProjectile(ASProjectileBase* Replicated);
+
+	// a predicted magic projectile hit Target, ViewTime is the server time of what the client saw
+	UFUNCTION(Server, Reliable)
+	void ServerClaimProjectileHit(int32 PredictionId, AActor* Target, FVector_NetQuantize HitLocation, double ViewTime);
+
+	// server time of the other pawns as this client currently sees them
+	double GetViewedServerTime() const;
+
 protected:
 
 	UPROPERTY(EditAnywhere, Category = "Attack")
-	TSubclassOf<AActor> MagicProjectileClass;
+	TSubclassOf<ASProjectileBase> MagicProjectileClass;
 
 	UPROPERTY(EditAnywhere, Category = "Attack")
-	TSubclassOf<AActor> BlackHoleProjectileClass;
+	TSubclassOf<ASProjectileBase> BlackHoleProjectileClass;
 
 	UPROPERTY(EditAnywhere, Category = "Attack")
-	TSubclassOf<AActor> TeleportProjectileClass;
+	TSubclassOf<ASProjectileBase> TeleportProjectileClass;
+
+	// shortest time between two primary attacks
+	UPROPERTY(EditDefaultsOnly, Category = "Attack")
+	float PrimaryAttackInterval = 0.2f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Attack")
+	float BlackHoleCooldown = 5.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Attack")
+	float TeleportCooldown = 2.0f;
+
+	// the server rejects projectiles a client spawns further than this from the character
+	UPROPERTY(EditDefaultsOnly, Category = "Attack")
+	float MaxProjectileSpawnDistance = 500.0f;
 
 	UPROPERTY(EditAnywhere, Category = "Attack")
 	UAnimMontage* AttackAnim;
@@ -49,6 +75,9 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	USAttributeComponent* AttributeComp;
 
+	UPROPERTY(VisibleAnywhere, Category = "Components")
+	USHitFlashComponent* HitFlashComp;
+
 	FTimerHandle TimerHandlePrimaryAttack;
 	FTimerHandle TimerHandleSecondaryAttack;
 	FTimerHandle TimerHandleTeleport;
@@ -64,6 +93,10 @@ protected:
 	void PrimaryInteract();
 	void PrimaryAttack_TimeElapsed();
 
+	// interactables change server state (health, chests, potions), clients only ask the server to interact
+	UFUNCTION(Server, Reliable)
+	void ServerPrimaryInteract();
+
 	void SecondaryAttack();
 	void SecondaryAttack_TimeElapsed();
 
@@ -73,8 +106,34 @@ protected:
 	void ResetActiveTeleport();
 	void ResetActiveBlackHole();
 
-	static bool bActiveTeleport;
-	static bool bActiveBlackHole;
+	bool bActiveTeleport = false;
+	bool bActiveBlackHole = false;
+
+	// spawn on the server, or predict on a client and ask the server for the real one
+	void SpawnProjectile(TSubclassOf<ASProjectileBase> ProjectileClass);
+	ASProjectileBase* SpawnProjectileAt(TSubclassOf<ASProjectileBase> ProjectileClass, const FTransform& SpawnTM, int32 PredictionId);
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerSpawnProjectile(TSubclassOf<ASProjectileBase> ProjectileClass, const FTransform& SpawnTM, int32 PredictionId);
+
+	UFUNCTION(Client, Reliable)
+	void ClientRejectProjectile(int32 PredictionId);
+
+	// server side cooldown of every projectile (the primary attack's fire rate, black hole, teleport), the client
+	// timers are not trusted
+	bool ConsumeServerCooldown(TSubclassOf<ASProjectileBase> ProjectileClass);
+
+	float NextPrimaryAttackTime = 0.0f;
+	float ServerPrimaryAttackReadyTime = 0.0f;
+	float ServerBlackHoleReadyTime = 0.0f;
+	float ServerTeleportReadyTime = 0.0f;
+
+	// predicted copies waiting for their replicated projectile, by prediction id
+	TMap<int32, TWeakObjectPtr<ASProjectileBase>> PredictedProjectiles;
+	int32 LastPredictionId = 0;
+
+	// server: projectiles spawned for this client's predictions, waiting for a hit claim
+	TMap<int32, TWeakObjectPtr<ASProjectileBase>> ServerPredictedProjectiles;
 
 	UFUNCTION()
 	void OnHealthChange(AActor* InstigatorActor, USAttributeComponent* OwningComp, float NewHealth, float Delta);
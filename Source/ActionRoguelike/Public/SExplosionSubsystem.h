@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SAreaEffectSubsystem.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "SExplosionSubsystem.generated.h"
+
+struct FSExplosion
+{
+	// impulse, and damage to everything around it
+	FSAreaEffect Effect;
+
+	// damage applied to Target, the actor that set the explosion off
+	float Damage = 0.0f;
+	TWeakObjectPtr<AActor> Target;
+
+	// actor that exploded, one pending explosion per source
+	TWeakObjectPtr<AActor> Source;
+};
+
+// Resolves explosions in batches instead of in the hit callback that set them off. Explosions are queued and at most
+// MaxExplosionsPerFrame are resolved each frame, so a chain reaction is spread over frames. Explosions of a frame
+// that are close together form a cluster that is applied by the area effect subsystem with a single overlap query.
+UCLASS()
+class ACTIONROGUELIKE_API USExplosionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// queue an explosion, false if its source already has one pending
+	bool QueueExplosion(const FSExplosion& Explosion);
+
+	bool IsExplosionPending(const AActor* Source) const;
+
+	int32 GetNumQueued() const { return Queue.Num(); }
+
+	int32 MaxExplosionsPerFrame = 8;
+
+	// explosions only join a cluster while its overlap sphere stays within this many explosion radii
+	float MaxClusterRadiusScale = 2.0f;
+
+	// UWorldSubsystem
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	struct FCluster
+	{
+		FVector Center = FVector::ZeroVector;
+		float Radius = 0.0f;
+		TArray<int32, TInlineAllocator<8>> Explosions;
+	};
+
+	// group explosions into clusters, each cluster sphere encloses the spheres of its explosions
+	void BuildClusters(TConstArrayView<FSExplosion> Explosions, TArray<FCluster>& OutClusters) const;
+
+	void ResolveCluster(const FCluster& Cluster, TConstArrayView<FSExplosion> Explosions, TArray<FSAreaEffect>& Effects);
+
+	TArray<FSExplosion> Queue;
+	TSet<TObjectKey<AActor>> PendingSources;
+};
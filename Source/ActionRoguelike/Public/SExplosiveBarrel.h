@@ -19,6 +19,12 @@ public:
 	// Sets default values for this actor's properties
 	ASExplosiveBarrel();
 
+	// queue an explosion with the explosion subsystem, Target takes the damage
+	void Detonate(AActor* Target);
+
+	UPROPERTY(EditAnywhere, Category = "Explosion")
+	float Damage = 50.0f;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -34,9 +40,4 @@ protected:
 
 	UFUNCTION()
 	void Explode(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
-
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 };
@@ -25,4 +25,9 @@ public:
 
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent)
 	void Interact(APawn* InstigatorPawn);
+
+	// Interact through a per class dispatch cache: whether the class implements the interface and whether Interact
+	// is overridden in blueprint is resolved once per class, native implementations are called directly without
+	// ProcessEvent. false if Actor doesn't implement the interface
+	static bool DispatchInteract(AActor* Actor, APawn* InstigatorPawn);
 };
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "SPowerUpBase.h"
+#include "SSavableInterface.h"
 #include "SHealthPotion.generated.h"
 
 class UStaticMeshComponent;
@@ -12,7 +13,7 @@ class UStaticMeshComponent;
  * 
  */
 UCLASS()
-class ACTIONROGUELIKE_API ASHealthPotion : public ASPowerUpBase
+class ACTIONROGUELIKE_API ASHealthPotion : public ASPowerUpBase, public ISSavableInterface
 {
 	GENERATED_BODY()
 public:
@@ -23,12 +24,27 @@ protected:
 	UPROPERTY(VisibleAnywhere)
 		UStaticMeshComponent* MeshComp;
 
+	// used up on the server, clients show the replicated state
+	UPROPERTY(ReplicatedUsing = OnRep_IsActive)
 	bool IsActive;
+
+	UFUNCTION()
+	void OnRep_IsActive();
+
 	float HealAmount;
 	FTimerHandle TimerHandle;
 
 	void Reactivate();
 
 	void Interact_Implementation(APawn* InstigatorPawn);
+
+	float ReactivateDelay = 10.0f;
+
+public:
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// ISSavableInterface
+	virtual void SerializeSaveState(FArchive& Ar, int32 Version) override;
 	
 };
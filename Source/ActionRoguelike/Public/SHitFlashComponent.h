@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SHitFlashComponent.generated.h"
+
+class UMeshComponent;
+class UMaterialInstanceDynamic;
+
+// Flashes a mesh when its owner is hit. By default the hit time and flash color are set as parameters on dynamic
+// material instances that are created once when play starts and reused. Materials set up for it can read them as
+// custom primitive data instead, without any instances. Flashes are collected and written once at the end of the
+// frame, however many hits came in.
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class ACTIONROGUELIKE_API USHitFlashComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USHitFlashComponent();
+
+	// mesh to flash, the first mesh of the owner if not set
+	void SetFlashMesh(UMeshComponent* InFlashMesh) { FlashMesh = InFlashMesh; }
+
+	// flash now, written with the next end of frame update
+	void Flash();
+
+	UPROPERTY(EditAnywhere, Category = "HitFlash")
+	FLinearColor FlashColor = FLinearColor::Red;
+
+	// off: only TimeToHit is written, for materials that pick their own flash color
+	UPROPERTY(EditAnywhere, Category = "HitFlash")
+	bool bWriteFlashColor = true;
+
+	// write custom primitive data, the materials need TimeToHit and FlashColor set up as custom primitive data at
+	// TimeToHitIndex and the three after it (only TimeToHit without bWriteFlashColor). off: material parameters on
+	// instances created once, for materials that still use plain parameters
+	UPROPERTY(EditAnywhere, Category = "HitFlash")
+	bool bUseCustomPrimitiveData = false;
+
+	UPROPERTY(EditAnywhere, Category = "HitFlash", meta = (EditCondition = "bUseCustomPrimitiveData"))
+	int32 TimeToHitIndex = 0;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UPROPERTY()
+	UMeshComponent* FlashMesh;
+
+	UPROPERTY(Transient)
+	TArray<UMaterialInstanceDynamic*> FlashMaterials;
+
+	float PendingTimeToHit = 0.0f;
+};
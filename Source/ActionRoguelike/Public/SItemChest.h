@@ -5,13 +5,14 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "SGameplayInterface.h"
+#include "SSavableInterface.h"
 #include "SItemChest.generated.h"
 
 
 class UStaticMeshComponent;
 
 UCLASS()
-class ACTIONROGUELIKE_API ASItemChest : public AActor, public ISGameplayInterface
+class ACTIONROGUELIKE_API ASItemChest : public AActor, public ISGameplayInterface, public ISSavableInterface
 {
 	GENERATED_BODY()
 
@@ -31,6 +32,13 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// opened on the server, clients show the replicated state
+	UPROPERTY(ReplicatedUsing = UpdateLid)
+	bool bLidOpen = false;
+
+	UFUNCTION()
+	void UpdateLid();
+
 public:	
 
 	UPROPERTY(EditAnywhere)
@@ -39,4 +47,9 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// ISSavableInterface
+	virtual void SerializeSaveState(FArchive& Ar, int32 Version) override;
+
 };
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "SLagCompensationSubsystem.generated.h"
+
+class APawn;
+
+// where a pawn's collision capsule was at one server frame
+struct FSHitboxSample
+{
+	double Time = 0.0;
+	FVector Location = FVector::ZeroVector;
+};
+
+// fixed size ring buffer of hitbox samples, oldest samples are overwritten once it is full
+class ACTIONROGUELIKE_API FSHitboxHistory
+{
+public:
+	explicit FSHitboxHistory(int32 InCapacity = 64);
+
+	void Record(double Time, const FVector& Location);
+
+	// interpolated location at Time, clamped to the oldest and newest sample, false if nothing was recorded
+	bool Rewind(double Time, FVector& OutLocation) const;
+
+	int32 Num() const { return NumSamples; }
+	double GetOldestTime() const;
+
+	// capsule of the pawn, fixed while it is tracked
+	float Radius = 0.0f;
+	float HalfHeight = 0.0f;
+
+private:
+	const FSHitboxSample& GetSample(int32 Index) const { return Samples[(Head + Index) % Samples.Num()]; }
+
+	TArray<FSHitboxSample> Samples;
+
+	// index of the oldest sample
+	int32 Head = 0;
+	int32 NumSamples = 0;
+};
+
+// Server side lag compensation: records the capsule of every pawn at a fixed interval, so a hit a client reports
+// can be checked against where the pawns were at the time the client saw them.
+UCLASS()
+class ACTIONROGUELIKE_API USLagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// true if the actor is a pawn whose history is recorded, hits on it are validated by rewinding
+	bool IsTracked(const AActor* Actor) const;
+
+	// true if HitLocation was within Tolerance of the target's capsule at Time
+	bool ValidateHit(const AActor* Target, const FVector& HitLocation, double Time, float Tolerance) const;
+
+	// distance from a point to an upright capsule, 0 inside
+	static float DistanceToCapsule(const FVector& Point, const FVector& Center, float Radius, float HalfHeight);
+
+	// how far back a hit may be rewound, older timestamps are clamped to it
+	static const double MaxRewindSeconds;
+
+	// time between two samples, servers ticking faster skip frames so the history always covers MaxRewindSeconds
+	static const double RecordInterval;
+
+	// samples per pawn, enough for MaxRewindSeconds at RecordInterval, 32 bytes each so about 2 KB per pawn
+	static const int32 HistoryCapacity;
+
+	// UWorldSubsystem
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	void OnActorSpawned(AActor* Actor);
+	void TrackPawn(APawn* Pawn);
+
+	bool IsServer() const;
+
+	struct FTrackedPawn
+	{
+		TWeakObjectPtr<APawn> Pawn;
+		FSHitboxHistory History;
+	};
+
+	TMap<TObjectKey<AActor>, FTrackedPawn> TrackedPawns;
+
+	double NextRecordTime = 0.0;
+
+	FDelegateHandle ActorSpawnedHandle;
+};
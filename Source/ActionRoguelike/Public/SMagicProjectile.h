@@ -7,6 +7,8 @@
 #include "SProjectileBase.h"
 #include "SMagicProjectile.generated.h"
 
+class USAttributeComponent;
+
 
 UCLASS()
 class ACTIONROGUELIKE_API ASMagicProjectile : public ASProjectileBase
@@ -15,6 +17,11 @@ class ACTIONROGUELIKE_API ASMagicProjectile : public ASProjectileBase
 
 	ASMagicProjectile();
 
+public:
+
+	// server: the shooter reported that its predicted copy hit Target, check it against the rewound hitboxes
+	void ConfirmPredictedHit(AActor* Target, const FVector& HitLocation, double ViewTime);
+
 protected:
 
 	void BeginPlay();
@@ -25,6 +32,15 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "CameraShake")
 	TSubclassOf<UCameraShakeBase> CameraShakeDamage;
 
+	UPROPERTY(EditAnywhere, Category = "Damage")
+	float Damage = 20.0f;
+
+	// slack on top of the sphere radius when checking a claimed hit against the rewound capsule
+	UPROPERTY(EditAnywhere, Category = "Damage")
+	float HitTolerance = 30.0f;
+
+	void ApplyHit(AActor* OtherActor, USAttributeComponent* AttributeComp);
+
 	UFUNCTION()
 	void OnActorOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
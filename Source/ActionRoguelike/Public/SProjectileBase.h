@@ -22,11 +22,29 @@ public:
 	// Sets default values for this actor's properties
 	ASProjectileBase();
 
+	// id the owning client gave its predicted copy, 0 if the projectile was not predicted
+	int32 GetPredictionId() const { return PredictionId; }
+
+	// only valid before FinishSpawning, the id replicates with the initial bunch
+	void SetPredictionId(int32 InPredictionId) { PredictionId = InPredictionId; }
+
+	// the local copy a client fires ahead of the server, it never replicates
+	bool IsPredicted() const;
+
+	// hits of this copy may change gameplay state: server or standalone, never a client
+	bool HasGameplayAuthority() const;
+
+	// continue the flight of the predicted copy on this replicated one and remove the copy
+	void TakeOverFrom(ASProjectileBase* Predicted);
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 		USphereComponent* SphereComp;
 
@@ -44,6 +62,9 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	USoundBase* ImpactSoundBase;
 
+	UPROPERTY(Replicated)
+	int32 PredictionId = 0;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "SRoomActivationSubsystem.generated.h"
+
+class ULevel;
+
+// Keeps the content of generated rooms asleep until a player comes close. A room is a streamed level with
+// gateways in it; while it is dormant its actors don't tick, their physics bodies sleep and AI brains are paused.
+// Rooms wake when a player gets near one of their gateways or enters them, and fall asleep again once every
+// player is further away than the sleep radius.
+UCLASS()
+class ACTIONROGUELIKE_API USRoomActivationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// distance to a gateway that wakes a room
+	float WakeRadius = 3000.0f;
+
+	// distance to every gateway and the room bounds past which an active room falls asleep, larger than
+	// WakeRadius so rooms don't flicker at the edge
+	float SleepRadius = 4500.0f;
+
+	// seconds between activation updates
+	float UpdateInterval = 0.25f;
+
+	bool IsActorDormant(const AActor* Actor) const;
+
+	int32 GetNumActiveRooms() const { return NumActiveRooms; }
+	int32 GetNumRooms() const { return Rooms.Num(); }
+
+	// UWorldSubsystem
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	// tick state an actor had before it was put to sleep
+	struct FManagedActor
+	{
+		TWeakObjectPtr<AActor> Actor;
+		bool bTickWasEnabled = false;
+		TArray<TWeakObjectPtr<UActorComponent>> TickingComponents;
+	};
+
+	struct FRoom
+	{
+		FBox Bounds = FBox(ForceInit);
+		TArray<FVector> Gateways;
+		TArray<FManagedActor> Actors;
+		bool bActive = true;
+	};
+
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+	void OnLevelRemoved(ULevel* Level, UWorld* World);
+	void OnActorSpawned(AActor* Actor);
+
+	// add an actor of a room, and the ai controller of a pawn, asleep if the room is dormant
+	void AddActor(FRoom& Room, AActor* Actor);
+
+	// add the spawned actors that have begun play since, keeps the others waiting
+	void AddPendingActors();
+
+	static void SleepActor(FManagedActor& Managed);
+	static void WakeActor(FManagedActor& Managed);
+	void SetRoomActive(FRoom& Room, bool bActive);
+
+	// cell of the gateway grid a location falls into
+	FIntVector GetCell(const FVector& Location) const;
+	void RebuildGatewayCells();
+
+	void UpdateActivation();
+	void UpdateStats();
+
+	TMap<TObjectKey<ULevel>, FRoom> Rooms;
+
+	// deferred spawns (bulk spawned replacements, restored saves) are announced before they finish spawning, their
+	// components, ai controller and BeginPlay tick registration would undo the sleep; added once they began play
+	TArray<TWeakObjectPtr<AActor>> PendingActors;
+
+	// rooms by the cells of their gateways, so a player only checks the gateways around it
+	TMultiMap<FIntVector, TObjectKey<ULevel>> GatewayCells;
+	float CellSize = 2000.0f;
+
+	float TimeSinceUpdate = 0.0f;
+	int32 NumActiveRooms = 0;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+	FDelegateHandle ActorSpawnedHandle;
+};
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "SSavableInterface.generated.h"
+
+// This class does not need to be modified.
+UINTERFACE(MinimalAPI)
+class USSavableInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Runtime state an actor or component keeps in a save game snapshot. Actors implementing it, and actors with a
+ * component implementing it, are registered with the save game subsystem.
+ */
+class ACTIONROGUELIKE_API ISSavableInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	// write or read the state, Version is the snapshot version it was written with
+	virtual void SerializeSaveState(FArchive& Ar, int32 Version) = 0;
+};
@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GenerationManifest.h"
+#include "DungeonGenerationSubsystem.h"
+#include "SSaveGameSubsystem.generated.h"
+
+class ULevel;
+
+// how a saved actor is found again on load
+enum class ESSaveKeyType : uint8
+{
+	// placed in a level: level reference and actor name
+	Placed,
+	// replacement spawned by the dungeon generator: level reference and name of the actor it replaced
+	Generated,
+	// pawn of a player: index of its player controller
+	Player,
+	// spawned at runtime: re-spawned from its class on load
+	Spawned
+};
+
+struct FSSaveKey
+{
+	ESSaveKeyType Type = ESSaveKeyType::Placed;
+	FManifestLevelRef Level;
+	FName Name;
+	int32 Index = 0;
+
+	bool operator==(const FSSaveKey& Other) const
+	{
+		return Type == Other.Type && Level == Other.Level && Name == Other.Name && Index == Other.Index;
+	}
+
+	friend uint32 GetTypeHash(const FSSaveKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.Type), GetTypeHash(Key.Level.PackageKey));
+		Hash = HashCombine(Hash, GetTypeHash(Key.Level.Ordinal));
+		Hash = HashCombine(Hash, GetTypeHash(Key.Name));
+		return HashCombine(Hash, GetTypeHash(Key.Index));
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FSSaveKey& Key)
+	{
+		return Ar << Key.Type << Key.Level << Key.Name << Key.Index;
+	}
+};
+
+// saved state of one actor, the state blobs are length prefixed so a reader can skip what it can't apply
+struct FSActorRecord
+{
+	FSSaveKey Key;
+	FString ClassPath;
+	FTransform Transform;
+
+	// state of the actor itself, empty if it isn't savable
+	TArray<uint8> ActorState;
+
+	// state of its savable components, by component name
+	TArray<TPair<FName, TArray<uint8>>> ComponentStates;
+
+	friend FArchive& operator<<(FArchive& Ar, FSActorRecord& Record)
+	{
+		return Ar << Record.Key << Record.ClassPath << Record.Transform << Record.ActorState << Record.ComponentStates;
+	}
+};
+
+// everything a save game holds: the dungeon manifest and the state of all savable actors
+struct FSSaveSnapshot
+{
+	static constexpr uint32 MagicNumber = 0x56535241; // "ARSV"
+	static constexpr int32 CurrentVersion = 1;
+
+	// larger sizes in a file header are corrupt, reading won't allocate for them
+	static constexpr int32 MaxUncompressedSize = 256 * 1024 * 1024;
+
+	int32 Version = CurrentVersion;
+	bool bHasManifest = false;
+	FGenerationManifest Manifest;
+	TArray<FSActorRecord> Actors;
+
+	friend FArchive& operator<<(FArchive& Ar, FSSaveSnapshot& Snapshot);
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSaveGameFinished, const FString&, SlotName, bool, bSuccess);
+
+// Saves and resumes a run: a registry of savable actors, a compact versioned binary snapshot of their state and
+// the dungeon manifest. The state is gathered on the game thread, compression and file IO run on the thread pool.
+// On load the dungeon is re-created from the manifest first, then missing runtime actors are spawned deferred so
+// their state is in place before BeginPlay.
+UCLASS()
+class ACTIONROGUELIKE_API USSaveGameSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "SaveGame")
+	bool SaveGame(const FString& SlotName);
+
+	UFUNCTION(BlueprintCallable, Category = "SaveGame")
+	bool LoadGame(const FString& SlotName);
+
+	UFUNCTION(BlueprintPure, Category = "SaveGame")
+	bool IsBusy() const { return bSaving || bLoading; }
+
+	UPROPERTY(BlueprintAssignable, Category = "SaveGame")
+	FOnSaveGameFinished OnGameSaved;
+
+	UPROPERTY(BlueprintAssignable, Category = "SaveGame")
+	FOnSaveGameFinished OnGameLoaded;
+
+	// state of all registered actors, game thread only
+	void CaptureSnapshot(FSSaveSnapshot& OutSnapshot);
+
+	// apply the actor records to the world, returns the number of restored actors
+	int32 RestoreActors(const FSSaveSnapshot& Snapshot);
+
+	// snapshot <-> compressed file bytes, safe on any thread
+	static bool WriteSnapshot(FSSaveSnapshot& Snapshot, TArray<uint8>& OutBytes);
+	static bool ReadSnapshot(const TArray<uint8>& Bytes, FSSaveSnapshot& OutSnapshot);
+
+	static FString GetSlotPath(const FString& SlotName);
+
+	// UWorldSubsystem
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+private:
+	void RegisterActor(AActor* Actor, bool bPlaced);
+	void OnActorSpawned(AActor* Actor);
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+
+	static bool IsSavable(const AActor* Actor);
+
+	// level references of all loaded levels, the persistent level maps to an empty reference
+	TMap<const ULevel*, FManifestLevelRef> MakeLoadedLevelRefs() const;
+
+	bool MakeKey(const AActor* Actor, bool bPlaced, const TMap<const ULevel*, FManifestLevelRef>& LevelRefs,
+		const TMap<const APawn*, int32>& PlayerPawns, FSSaveKey& OutKey) const;
+
+	// called on the game thread once the file is read
+	void OnSnapshotRead(const FString& SlotName, TSharedPtr<FSSaveSnapshot> Snapshot);
+
+	UFUNCTION()
+	void OnDungeonRestored(const FDungeonGenerationStats& Stats);
+
+	void FinishLoad(bool bSuccess);
+
+	// savable actors, true for actors that were placed in a level
+	TMap<TWeakObjectPtr<AActor>, bool> SavableActors;
+
+	bool bSaving = false;
+	bool bLoading = false;
+
+	// snapshot waiting for the dungeon to be re-created
+	TSharedPtr<FSSaveSnapshot> PendingSnapshot;
+	FString PendingSlotName;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+};
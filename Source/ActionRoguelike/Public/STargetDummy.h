@@ -8,6 +8,7 @@
 
 class USAttributeComponent;
 class UStaticMeshComponent;
+class USHitFlashComponent;
 
 UCLASS()
 class ACTIONROGUELIKE_API ASTargetDummy : public AActor
@@ -26,6 +27,9 @@ protected:
 	UPROPERTY(VisibleAnywhere)
 	UStaticMeshComponent* MeshComp;
 
+	UPROPERTY(VisibleAnywhere)
+	USHitFlashComponent* HitFlashComp;
+
 	UFUNCTION()
 	void OnHealthChange(AActor* InstigatorActor, USAttributeComponent* OwningComp, float NewHealth, float Delta);
 